@@ -2,7 +2,11 @@
 #include <fstream>
 #include <sstream>
 
+#include "lib/batchRunner.h"
+#include "lib/distanceOracle.h"
 #include "lib/graphSolver.h"
+#include "lib/taskRunner.h"
+#include "lib/treeIndex.h"
 
 //graph of Europe
 std::stringstream europe("Albania: Macedonia, Montenegro, Serbia\n"
@@ -119,7 +123,76 @@ std::map<std::string, std::vector<std::pair<std::string, int>>> distances = {
         { "Vatican", {{"Italy", 5}}},
 };
 
-int main() {
+/**
+ * It runs the batch mode: GraphSolver --batch <directory or manifest> [--analyses radius,clique,...] [--threads n]
+ * [--search-ms t] [--output file]. The results go to the output file or to stdout as JSON lines, and a summary to
+ * stderr.
+ *
+ * Returns:
+ *   The exit code: 0 if every graph was solved, 1 if some failed, 2 for a bad command line.
+ */
+int RunBatchCommand(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --batch <directory or manifest> [--analyses a,b,...] [--threads n]"
+                  << " [--search-ms t] [--output file]\n";
+        return 2;
+    }
+
+    batchOptions options;
+    std::string output;
+    try {
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string flag = argv[i];
+            std::string value = argv[i + 1];
+
+            if (flag == "--analyses") {
+                options.analyses.clear();
+                std::stringstream names(value);
+                for (std::string name; std::getline(names, name, ',');) {
+                    options.analyses.push_back(ParseBatchAnalysis(name));
+                }
+            } else if (flag == "--threads") {
+                options.threads = std::stoul(value);
+            } else if (flag == "--search-ms") {
+                options.search_time = std::chrono::milliseconds(std::stoul(value));
+            } else if (flag == "--output") {
+                output = value;
+            } else {
+                throw std::invalid_argument("unknown option " + flag);
+            }
+        }
+        if (argc % 2 == 0) throw std::invalid_argument(std::string("no value for ") + argv[argc - 1]);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 2;
+    }
+
+    std::vector<std::string> files;
+    try {
+        files = BatchInputs(argv[2]);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 2;
+    }
+
+    std::ofstream output_file;
+    if (!output.empty()) {
+        output_file.open(output);
+        if (!output_file) {
+            std::cerr << "cannot write " << output << '\n';
+            return 2;
+        }
+    }
+
+    batchSummary summary = RunBatch(files, options, output.empty() ? std::cout : output_file);
+    std::cerr << summary.graphs << " graphs, " << summary.failed << " failed, " << summary.elapsed_seconds << " s\n";
+    return summary.failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+/// Batch mode) solve many graph files in one process instead of the tasks below
+    if (argc > 1 && std::string(argv[1]) == "--batch") return RunBatchCommand(argc, argv);
+
 //graph initializing
 ////-----------------/////
     graphSolver g;
@@ -143,6 +216,15 @@ int main() {
 //
 //    std::cout << '\n';
 
+/// Task b, many queries) the hop distance between any two countries from a table built once; Save and Load keep it
+//between runs, so later runs answer without any BFS.
+//
+//    distanceOracle oracle = distanceOracle::Build(g.Compact());
+//    oracle.Save("europe.dist");
+//
+//    distanceOracle loaded = distanceOracle::Load("europe.dist");
+//    std::cout << "Hops Portugal - Russia : " << loaded.Distance("Portugal", "Russia") << '\n';
+
 ///Task e) Find maximum clique
 
 //    auto max_clique = g.Bronkerbosch();
@@ -184,52 +266,12 @@ int main() {
 
 /// Task k) Find the closed walk U that visits every edges
 
-//    std::stringstream reduced_europe("Albania: Macedonia, Montenegro, Serbia\n"
-//                                 "Andorra: France, Spain\n"
-//                                 "Austria: Czechia, Germany, Hungary, Italy, Liechtenstein, Slovenia\n"
-//                                 "Belarus: Latvia, Lithuania, Russia, Ukraine\n"
-//                                 "Belgium: France, Germany, Luxembourg, Netherlands\n"
-//                                 "Bosnia: Montenegro, Serbia\n"
-//                                 "Bulgaria: Greece, Macedonia, Serbia, Turkey\n"
-//                                 "Croatia: Hungary, Montenegro, Serbia, Slovenia\n"
-//                                 "Czechia: Austria, Germany, Poland, Slovakia\n"
-//                                 "Denmark:\n"
-//                                 "Estonia: Latvia, Russia\n"
-//                                 "Finland: Sweden, Russia\n"
-//                                 "France: Andorra, Belgium, Germany, Italy, Spain, Switzerland\n"
-//                                 "Germany: Austria, Belgium, Czechia, France, Luxembourg, Netherlands, Poland, Switzerland\n"
-//                                 "Greece: Albania, Bulgaria, Macedonia, Turkey\n"
-//                                 "Hungary: Austria, Croatia, Romania, Serbia, Slovakia, Slovenia\n"
-//                                 "Italy: Austria, France, Slovenia, Switzerland\n"
-//                                 "Latvia: Belarus, Estonia, Lithuania, Russia\n"
-//                                 "Liechtenstein: Austria, Switzerland\n"
-//                                 "Lithuania: Belarus, Latvia, Poland, Russia\n"
-//                                 "Luxembourg: Belgium, Germany\n"
-//                                 "Macedonia: Albania, Bulgaria, Greece, Serbia\n"
-//                                 "Moldova: Romania, Ukraine\n"
-//                                 "Monaco: \n"
-//                                 "Montenegro: Albania, Bosnia, Croatia, Serbia\n"
-//                                 "Netherlands: Belgium, Germany\n"
-//                                 "Norway: Russia, Sweden\n"
-//                                 "Poland: Czechia, Germany, Lithuania, Russia, Slovakia, Ukraine\n"
-//                                 "Portugal: \n"
-//                                 "Romania: Hungary, Moldova, Serbia, Ukraine\n"
-//                                 "Russia: Belarus, Estonia, Finland, Latvia, Lithuania, Norway, Ukraine, Poland\n"
-//                                 "San Marino: \n"
-//                                 "Serbia: Albania, Bosnia, Bulgaria, Croatia, Hungary, Montenegro, Macedonia, Romania\n"
-//                                 "Slovakia: Czechia, Hungary, Poland, Ukraine\n"
-//                                 "Slovenia: Austria, Croatia, Hungary, Italy\n"
-//                                 "Spain: Andorra, France\n"
-//                                 "Sweden: Finland, Norway\n"
-//                                 "Switzerland: France, Germany, Italy, Liechtenstein\n"
-//                                 "Turkey: Bulgaria, Greece\n"
-//                                 "Ukraine: Belarus, Moldova, Poland, Romania, Russia, Slovakia\n"
-//                                 "Vatican: ");
-//
-//    graphSolver reduced_g;
-//    reduced_europe >> reduced_g;
+//    postmanWalk U = g.FindPostmanWalk();
 //
-//    reduced_g.FindEulerPath();
+//    std::cout << "Closed walk of length " << U.length << ", " << U.repeated << " edges repeated : \n";
+//    for (const auto& country : U.walk) {
+//        std::cout << country << " -> ";
+//    }
 
 /// Task n) Add the weight functionw : E → R denoting the distanc between capitals. Find the minimum
 //(w.r.t. the total weight of edges) spanning tree T for the largest connected component of the
@@ -250,6 +292,28 @@ int main() {
 //        std::cout << connected.first << " " << connected.second << " " << cost << '\n';
 //    }
 
+/// Task n, read from a file) the same distances are in docs/europe_distances.txt; LoadWeighted reads them straight
+//into the weights of the graph and reports the pairs of countries whose two directions disagree.
+//
+//    std::ifstream europe_distances("docs/europe_distances.txt");
+//    graphSolver weighted_g;
+//    loadReport report = weighted_g.LoadWeighted(europe_distances);
+//
+//    for (const auto& problem : report.problems) {
+//        std::cout << problem << '\n';
+//    }
+//
+//    spanningTree weighted_minimum_spanning_tree = weighted_g.FindMinimumSpanningTree();
+
+/// All tasks at once) run the analyses concurrently on a read-only snapshot of the graph
+
+//    taskRunner runner(std::make_shared<const graphSnapshot>(g));
+//    for (auto& task : StandardTasks(distances)) {
+//        runner.Add(task);
+//    }
+//
+//    runner.Run().Print(std::cout);
+
 /// Task o) Find centroid(T ) (w.r.t. the edge weight function w).
 
     auto T = g.FindMinimumSpanningTree(distances);
@@ -258,6 +322,12 @@ int main() {
 
     std::cout << "Founded centroid : " << centroid.first << " " << centroid.second << '\n';
 
+/// Task o, path queries) the bottleneck and the length of the route between two countries in T
+//
+//    treeIndex T_index(T);
+//    std::cout << "Bottleneck Portugal - Russia : " << T_index.HeaviestEdge("Portugal", "Russia") << '\n';
+//    std::cout << "Length Portugal - Russia : " << T_index.PathWeight("Portugal", "Russia") << '\n';
+
 /// Task p) Construct the Prufer code for  ̈ T.
 
     std::string prufer_code = g.PruferCode(T);
@@ -265,6 +335,13 @@ int main() {
     std::cout << "Constructed the Prufer code : " << std::endl;
 
     std::cout << prufer_code;
+
+/// Memory) the heap use of every method above, in builds with -DGRAPHSOLVER_PROFILE_ALLOCATIONS=ON
+
+    if (AllocationProfilingEnabled()) {
+        std::cout << "\n\n";
+        PrintAllocationSummary(std::cout);
+    }
 }
 
 
@@ -0,0 +1,156 @@
+#include "allocationProfiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+
+#include <malloc.h>
+
+namespace {
+    //The counters of one thread. They are plain integers with constant initialization, so operator new can use them
+    //before anything else of the thread is constructed.
+    struct threadCounters {
+        size_t allocations;
+        size_t bytes_allocated;
+        int64_t live_bytes;     //may go below zero when the thread frees blocks of another thread
+        int64_t peak_live_bytes;
+        bool paused;            //set while the profile itself allocates
+    };
+
+    thread_local threadCounters counters{};
+
+    std::mutex profile_mutex;
+
+    std::map<std::string, allocationStats>& Profile() {
+        static auto* profile = new std::map<std::string, allocationStats>();
+        return *profile;
+    }
+}
+
+#ifdef GRAPHSOLVER_PROFILE_ALLOCATIONS
+namespace {
+    void Count(void* block) {
+        if (!block || counters.paused) return;
+
+        int64_t bytes = malloc_usable_size(block);
+        counters.allocations++;
+        counters.bytes_allocated += bytes;
+        counters.live_bytes += bytes;
+        counters.peak_live_bytes = std::max(counters.peak_live_bytes, counters.live_bytes);
+    }
+
+    void Uncount(void* block) {
+        if (!block || counters.paused) return;
+
+        counters.live_bytes -= static_cast<int64_t>(malloc_usable_size(block));
+    }
+
+    void* Allocate(size_t size) {
+        void* block = std::malloc(size ? size : 1);
+        if (!block) throw std::bad_alloc();
+        Count(block);
+        return block;
+    }
+
+    void* AllocateAligned(size_t size, std::align_val_t alignment) {
+        size_t align = static_cast<size_t>(alignment);
+        void* block = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align);
+        if (!block) throw std::bad_alloc();
+        Count(block);
+        return block;
+    }
+
+    void Release(void* block) {
+        Uncount(block);
+        std::free(block);
+    }
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return Allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return Allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+
+void operator delete(void* block) noexcept { Release(block); }
+void operator delete[](void* block) noexcept { Release(block); }
+void operator delete(void* block, size_t) noexcept { Release(block); }
+void operator delete[](void* block, size_t) noexcept { Release(block); }
+void operator delete(void* block, std::align_val_t) noexcept { Release(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { Release(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { Release(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { Release(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { Release(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { Release(block); }
+
+bool AllocationProfilingEnabled() { return true; }
+#else
+bool AllocationProfilingEnabled() { return false; }
+#endif
+
+/**
+ * It remembers the counters of the thread, and restarts the peak from the bytes live now, so the destructor can tell
+ * the peak of this call apart from the peak of the calls around it.
+ */
+allocationScope::allocationScope(const char* method)
+        : method(method),
+          allocations(counters.allocations),
+          bytes_allocated(counters.bytes_allocated),
+          live_bytes(counters.live_bytes),
+          outer_peak(counters.peak_live_bytes) {
+    counters.peak_live_bytes = counters.live_bytes;
+}
+
+allocationScope::~allocationScope() {
+    size_t peak = static_cast<size_t>(counters.peak_live_bytes - live_bytes);
+    size_t call_allocations = counters.allocations - allocations;
+    size_t call_bytes = counters.bytes_allocated - bytes_allocated;
+    counters.peak_live_bytes = std::max(outer_peak, counters.peak_live_bytes);
+
+    bool paused = counters.paused;
+    counters.paused = true;
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex);
+        allocationStats& stats = Profile()[method];
+        stats.calls++;
+        stats.allocations += call_allocations;
+        stats.bytes_allocated += call_bytes;
+        stats.peak_live_bytes = std::max(stats.peak_live_bytes, peak);
+    }
+    counters.paused = paused;
+}
+
+std::map<std::string, allocationStats> AllocationProfile() {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    return Profile();
+}
+
+void ResetAllocationProfile() {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    Profile().clear();
+}
+
+void PrintAllocationSummary(std::ostream& out) {
+    auto profile = AllocationProfile();
+    if (!AllocationProfilingEnabled()) {
+        out << "Allocation profiling is off; build with -DGRAPHSOLVER_PROFILE_ALLOCATIONS=ON\n";
+        return;
+    }
+
+    out << std::left << std::setw(48) << "method" << std::right << std::setw(8) << "calls" << std::setw(14)
+        << "allocations" << std::setw(16) << "bytes" << std::setw(16) << "peak bytes" << '\n';
+    for (const auto& [method, stats] : profile) {
+        out << std::left << std::setw(48) << method << std::right << std::setw(8) << stats.calls << std::setw(14)
+            << stats.allocations << std::setw(16) << stats.bytes_allocated << std::setw(16) << stats.peak_live_bytes
+            << '\n';
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef GRAPHSOLVER_ALLOCATIONPROFILER_H
+#define GRAPHSOLVER_ALLOCATIONPROFILER_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+//What the calls of one method took from the heap, on the thread that ran them. Bytes are the usable sizes of the
+//blocks, as malloc_usable_size reports them.
+struct allocationStats {
+    size_t calls = 0;
+    size_t allocations = 0;
+    size_t bytes_allocated = 0;
+    size_t peak_live_bytes = 0;     //the most bytes held at once above what was live when the call started
+};
+
+//Counts the heap use of the current thread between its construction and destruction, and adds it to the profile of
+//`method`. Scopes may nest: an inner call is counted in the outer method too.
+class allocationScope {
+public:
+    explicit allocationScope(const char* method);
+
+    ~allocationScope();
+
+    allocationScope(const allocationScope&) = delete;
+    allocationScope& operator=(const allocationScope&) = delete;
+
+private:
+    const char* method;
+    size_t allocations;
+    size_t bytes_allocated;
+    int64_t live_bytes;
+    int64_t outer_peak;
+};
+
+//True if the build replaces operator new and delete (the CMake option GRAPHSOLVER_PROFILE_ALLOCATIONS). Without it
+//the scopes are not compiled in and the profile stays empty.
+bool AllocationProfilingEnabled();
+
+//The profile of every method that ran so far, over all threads.
+std::map<std::string, allocationStats> AllocationProfile();
+
+void ResetAllocationProfile();
+
+//Prints one line per method: calls, allocations, bytes allocated and the peak live bytes.
+void PrintAllocationSummary(std::ostream& out);
+
+//Put at the top of a method to profile it in builds with GRAPHSOLVER_PROFILE_ALLOCATIONS; it costs nothing otherwise.
+#ifdef GRAPHSOLVER_PROFILE_ALLOCATIONS
+#define PROFILE_ALLOCATIONS(method) allocationScope allocation_scope_(method)
+#else
+#define PROFILE_ALLOCATIONS(method)
+#endif
+
+#endif //GRAPHSOLVER_ALLOCATIONPROFILER_H
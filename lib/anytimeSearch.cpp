@@ -0,0 +1,603 @@
+#include "anytimeSearch.h"
+
+#include <algorithm>
+#include <set>
+
+searchBudget searchBudget::Within(std::chrono::milliseconds time) {
+    searchBudget budget;
+    budget.deadline = std::chrono::steady_clock::now() + time;
+    return budget;
+}
+
+searchMonitor::searchMonitor(const searchBudget& budget) : budget(budget), start(std::chrono::steady_clock::now()) {}
+
+/**
+ * It counts a search node and checks the limits of the budget. The clock and the cancellation flag are only read
+ * every 1024 nodes, so the check costs almost nothing per node.
+ *
+ * Args:
+ *   incumbent (size_t): the size of the best solution so far, for the progress report
+ *   upper_bound (size_t): the best known bound on the optimum, for the progress report
+ *
+ * Returns:
+ *   True if the search must stop. Once it returned true, it keeps returning true.
+ */
+bool searchMonitor::Stop(size_t incumbent, size_t upper_bound) {
+    if (stopped) return true;
+
+    nodes++;
+
+    if (budget.progress && budget.progress_interval && nodes % budget.progress_interval == 0) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        budget.progress({nodes, incumbent, upper_bound, elapsed.count()});
+    }
+
+    if (nodes >= budget.node_limit) stopped = true;
+
+    if (nodes % 1024 == 1) {
+        if (budget.cancel && budget.cancel->load(std::memory_order_relaxed)) stopped = true;
+        if (std::chrono::steady_clock::now() >= budget.deadline) stopped = true;
+    }
+
+    return stopped;
+}
+
+namespace {
+    using adjacencyList = std::vector<std::vector<size_t>>;
+
+    const size_t none = SIZE_MAX;
+
+    bool Adjacent(const adjacencyList& adjacency, size_t u, size_t v) {
+        return std::binary_search(adjacency[u].begin(), adjacency[u].end(), v);
+    }
+
+    //A vertex set that can be refilled in O(|set|): every Assign starts a new epoch instead of clearing the marks.
+    struct membership {
+        std::vector<size_t> mark;
+        size_t epoch = 1;
+
+        explicit membership(size_t n) : mark(n, 0) {}
+
+        void Assign(const std::vector<size_t>& vertices) {
+            epoch++;
+            for (size_t v : vertices) mark[v] = epoch;
+        }
+
+        void Clear() { epoch++; }
+
+        void Insert(size_t v) { mark[v] = epoch; }
+
+        void Remove(size_t v) { mark[v] = 0; }
+
+        bool Contains(size_t v) const { return mark[v] == epoch; }
+    };
+
+    /* A greedy maximal matching of the vertices in `in`, optionally counting the isolated ones. */
+    size_t GreedyMatching(const adjacencyList& adjacency, const std::vector<size_t>& vertices, const membership& in,
+                          membership& matched, std::vector<std::pair<size_t, size_t>>* pairs = nullptr,
+                          size_t* isolated = nullptr) {
+        matched.Clear();
+        size_t size = 0;
+
+        for (size_t u : vertices) {
+            bool has_neighbour = false;
+            for (size_t w : adjacency[u]) {
+                if (!in.Contains(w)) continue;
+                has_neighbour = true;
+
+                if (!matched.Contains(u) && !matched.Contains(w)) {
+                    matched.Insert(u);
+                    matched.Insert(w);
+                    if (pairs) pairs->emplace_back(u, w);
+                    size++;
+                }
+            }
+            if (isolated && !has_neighbour) ++*isolated;
+        }
+
+        return size;
+    }
+
+    /* Repeatedly removes a vertex u of degree at most 1 in `vertices` together with its neighbour w (none if u is
+    isolated) and reports the pair to `take`. Taking u into a stable set, or matching u with w, is always optimal. */
+    template <typename Take>
+    void ReduceLowDegree(const adjacencyList& adjacency, std::vector<size_t>& vertices, membership& in,
+                         std::vector<size_t>& degree, const Take& take) {
+        in.Assign(vertices);
+
+        std::vector<size_t> low;
+        for (size_t u : vertices) {
+            degree[u] = 0;
+            for (size_t w : adjacency[u]) {
+                if (in.Contains(w)) degree[u]++;
+            }
+            if (degree[u] <= 1) low.push_back(u);
+        }
+
+        if (low.empty()) return;
+
+        auto remove = [&](size_t v) {
+            in.Remove(v);
+            for (size_t x : adjacency[v]) {
+                if (in.Contains(x) && --degree[x] == 1) low.push_back(x);
+            }
+        };
+
+        while (!low.empty()) {
+            size_t u = low.back();
+            low.pop_back();
+            if (!in.Contains(u)) continue;
+
+            size_t w = none;
+            for (size_t x : adjacency[u]) {
+                if (in.Contains(x)) {
+                    w = x;
+                    break;
+                }
+            }
+
+            take(u, w);
+            remove(u);
+            if (w != none) remove(w);
+        }
+
+        vertices.erase(std::remove_if(vertices.begin(), vertices.end(), [&in](size_t v) {
+            return !in.Contains(v);
+        }), vertices.end());
+    }
+
+    struct cliqueSearch {
+        const adjacencyList& adjacency;
+        searchMonitor& monitor;
+        std::vector<size_t> clique;
+        std::vector<size_t> best;
+        size_t open_bound = 0;
+        size_t root_bound = 0;
+
+        cliqueSearch(const adjacencyList& adjacency, searchMonitor& monitor) : adjacency(adjacency), monitor(monitor) {}
+
+        /* Greedy coloring of the candidates; reorders them by color and returns the number of colors, which bounds
+        the size of any clique among them. */
+        size_t Color(std::vector<size_t>& candidates) {
+            std::vector<std::vector<size_t>> classes;
+            for (size_t u : candidates) {
+                size_t k = 0;
+                while (k < classes.size() && std::any_of(classes[k].begin(), classes[k].end(), [&](size_t x) {
+                    return Adjacent(adjacency, u, x);
+                })) {
+                    k++;
+                }
+
+                if (k == classes.size()) classes.emplace_back();
+                classes[k].push_back(u);
+            }
+
+            candidates.clear();
+            for (const auto& color_class : classes) {
+                candidates.insert(candidates.end(), color_class.begin(), color_class.end());
+            }
+
+            return classes.size();
+        }
+
+        void Search(std::vector<size_t> candidates) {
+            while (true) {
+                size_t bound = clique.size() + Color(candidates);
+
+                if (monitor.Stop(best.size(), root_bound)) {
+                    open_bound = std::max(open_bound, bound);
+                    return;
+                }
+
+                if (candidates.empty()) {
+                    if (clique.size() > best.size()) best = clique;
+                    return;
+                }
+
+                if (bound <= best.size()) return;
+
+                /* Branching on the vertex with the highest color: with it, or never again in this subtree. */
+                size_t v = candidates.back();
+                candidates.pop_back();
+
+                std::vector<size_t> next;
+                for (size_t u : candidates) {
+                    if (Adjacent(adjacency, v, u)) next.push_back(u);
+                }
+
+                clique.push_back(v);
+                Search(std::move(next));
+                clique.pop_back();
+
+                if (monitor.stopped) {
+                    open_bound = std::max(open_bound, clique.size() + Color(candidates));
+                    return;
+                }
+            }
+        }
+    };
+
+    struct stableSetSearch {
+        const adjacencyList& adjacency;
+        searchMonitor& monitor;
+        membership in;
+        membership matched;
+        std::vector<size_t> degree;
+        std::vector<size_t> stable;
+        std::vector<size_t> best;
+        size_t open_bound = 0;
+        size_t root_bound = 0;
+
+        stableSetSearch(const adjacencyList& adjacency, searchMonitor& monitor)
+            : adjacency(adjacency), monitor(monitor), in(adjacency.size()), matched(adjacency.size()),
+              degree(adjacency.size()) {}
+
+        /* Every edge of a matching has at most one endpoint in a stable set. */
+        size_t Bound(const std::vector<size_t>& candidates) {
+            in.Assign(candidates);
+            return candidates.size() - GreedyMatching(adjacency, candidates, in, matched);
+        }
+
+        void Search(std::vector<size_t> candidates) {
+            size_t taken = stable.size();
+
+            while (true) {
+                ReduceLowDegree(adjacency, candidates, in, degree, [this](size_t u, size_t) {
+                    stable.push_back(u);
+                });
+
+                if (candidates.empty()) {
+                    if (stable.size() > best.size()) best = stable;
+                    break;
+                }
+
+                size_t bound = stable.size() + Bound(candidates);
+
+                if (monitor.Stop(best.size(), root_bound)) {
+                    open_bound = std::max(open_bound, bound);
+                    break;
+                }
+
+                if (bound <= best.size()) break;
+
+                /* Branching on the vertex of maximum degree: taking it removes the most candidates. */
+                in.Assign(candidates);
+                size_t v = candidates.front();
+                size_t max_degree = 0;
+                for (size_t u : candidates) {
+                    size_t d = 0;
+                    for (size_t w : adjacency[u]) {
+                        if (in.Contains(w)) d++;
+                    }
+                    if (d > max_degree) {
+                        max_degree = d;
+                        v = u;
+                    }
+                }
+
+                std::vector<size_t> next;
+                for (size_t u : candidates) {
+                    if (u != v && !Adjacent(adjacency, v, u)) next.push_back(u);
+                }
+
+                stable.push_back(v);
+                Search(std::move(next));
+                stable.pop_back();
+
+                candidates.erase(std::find(candidates.begin(), candidates.end(), v));
+
+                if (monitor.stopped) {
+                    open_bound = std::max(open_bound, stable.size() + Bound(candidates));
+                    break;
+                }
+            }
+
+            stable.resize(taken);
+        }
+    };
+
+    struct matchingSearch {
+        const adjacencyList& adjacency;
+        searchMonitor& monitor;
+        membership in;
+        membership matched;
+        std::vector<size_t> degree;
+        std::vector<std::pair<size_t, size_t>> current;
+        std::vector<std::pair<size_t, size_t>> best;
+        size_t open_bound = 0;
+        size_t root_bound = 0;
+
+        matchingSearch(const adjacencyList& adjacency, searchMonitor& monitor)
+            : adjacency(adjacency), monitor(monitor), in(adjacency.size()), matched(adjacency.size()),
+              degree(adjacency.size()) {}
+
+        /* The endpoints of a maximal matching cover every edge, and isolated vertices are never matched. */
+        size_t Bound(const std::vector<size_t>& candidates) {
+            in.Assign(candidates);
+            size_t isolated = 0;
+            size_t greedy = GreedyMatching(adjacency, candidates, in, matched, nullptr, &isolated);
+            return std::min(2 * greedy, (candidates.size() - isolated) / 2);
+        }
+
+        void Search(std::vector<size_t> candidates) {
+            size_t taken = current.size();
+
+            while (true) {
+                ReduceLowDegree(adjacency, candidates, in, degree, [this](size_t u, size_t w) {
+                    if (w != none) current.emplace_back(u, w);
+                });
+
+                if (candidates.empty()) {
+                    if (current.size() > best.size()) best = current;
+                    break;
+                }
+
+                size_t bound = current.size() + Bound(candidates);
+
+                if (monitor.Stop(best.size(), root_bound)) {
+                    open_bound = std::max(open_bound, bound);
+                    break;
+                }
+
+                if (bound <= best.size()) break;
+
+                /* Branching on the vertex of minimum degree: it is matched with one of its neighbours, or not at all. */
+                in.Assign(candidates);
+                size_t u = candidates.front();
+                size_t min_degree = SIZE_MAX;
+                for (size_t v : candidates) {
+                    size_t d = 0;
+                    for (size_t w : adjacency[v]) {
+                        if (in.Contains(w)) d++;
+                    }
+                    if (d < min_degree) {
+                        min_degree = d;
+                        u = v;
+                    }
+                }
+
+                std::vector<size_t> partners;
+                for (size_t w : adjacency[u]) {
+                    if (in.Contains(w)) partners.push_back(w);
+                }
+
+                candidates.erase(std::find(candidates.begin(), candidates.end(), u));
+
+                for (size_t i = 0; i < partners.size(); i++) {
+                    std::vector<size_t> next;
+                    for (size_t v : candidates) {
+                        if (v != partners[i]) next.push_back(v);
+                    }
+
+                    current.emplace_back(u, partners[i]);
+                    Search(std::move(next));
+                    current.pop_back();
+
+                    if (monitor.stopped) {
+                        /* The remaining branches match u with another partner (+1) or leave it unmatched. */
+                        size_t rest = current.size() + (i + 1 < partners.size() ? 1 : 0) + Bound(candidates);
+                        open_bound = std::max(open_bound, rest);
+                        break;
+                    }
+                }
+
+                if (monitor.stopped) break;
+            }
+
+            current.resize(taken);
+        }
+    };
+
+    /* Tutte-Berge: the maximum matching has (n - max(odd(G - U) - |U|)) / 2 edges; U is tried empty and as every
+    single vertex (the latter only for graphs small enough for V BFS runs). */
+    size_t TutteBound(const adjacencyList& adjacency) {
+        size_t n = adjacency.size();
+        /* seen[v] is the pass that last reached v; passes count from 1, so no vertex starts as seen. */
+        std::vector<size_t> seen(n, 0);
+        std::vector<size_t> queue;
+        size_t pass = 0;
+
+        auto odd_components = [&](size_t removed) {
+            pass++;
+            size_t odd = 0;
+            for (size_t start = 0; start < n; start++) {
+                if (start == removed || seen[start] == pass) continue;
+
+                seen[start] = pass;
+                queue.assign(1, start);
+                for (size_t head = 0; head < queue.size(); head++) {
+                    for (size_t to : adjacency[queue[head]]) {
+                        if (to == removed || seen[to] == pass) continue;
+                        seen[to] = pass;
+                        queue.push_back(to);
+                    }
+                }
+
+                odd += queue.size() % 2;
+            }
+            return odd;
+        };
+
+        size_t max_deficiency = odd_components(none);
+
+        size_t arcs = 0;
+        for (const auto& neighbours : adjacency) arcs += neighbours.size();
+
+        if (n * (n + arcs) <= 50000000) {
+            for (size_t v = 0; v < n; v++) {
+                size_t odd = odd_components(v);
+                if (odd > 1) max_deficiency = std::max(max_deficiency, odd - 1);
+            }
+        }
+
+        return (n - max_deficiency) / 2;
+    }
+}
+
+/**
+ * It orders the vertices by repeatedly removing a vertex of minimum remaining degree.
+ *
+ * Args:
+ *   adjacency (vector<vector<size_t>>): the id adjacency lists
+ *
+ * Returns:
+ *   The vertex ids in degeneracy order.
+ */
+std::vector<size_t> DegeneracyOrder(const std::vector<std::vector<size_t>>& adjacency) {
+    size_t n = adjacency.size();
+
+    std::vector<size_t> degree(n);
+    std::set<std::pair<size_t, size_t>> queue;
+    for (size_t v = 0; v < n; v++) {
+        degree[v] = adjacency[v].size();
+        queue.insert({degree[v], v});
+    }
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    while (!queue.empty()) {
+        size_t v = queue.begin()->second;
+        queue.erase(queue.begin());
+        order.push_back(v);
+
+        for (size_t to : adjacency[v]) {
+            if (queue.erase({degree[to], to})) {
+                queue.insert({--degree[to], to});
+            }
+        }
+    }
+
+    return order;
+}
+
+/**
+ * It searches for a maximum clique within the budget.
+ *
+ * Every vertex v in degeneracy order is a subproblem on its later neighbours, whose greedy coloring bounds the
+ * cliques that contain v; the largest of those bounds is the root bound. The incumbent starts as a greedy clique.
+ *
+ * Returns:
+ *   The best clique (vertex ids) and the proven upper bound.
+ */
+searchResult<std::vector<size_t>> MaximumCliqueSearch(const std::vector<std::vector<size_t>>& adjacency,
+                                                      const searchBudget& budget) {
+    searchMonitor monitor(budget);
+    cliqueSearch search(adjacency, monitor);
+
+    std::vector<size_t> order = DegeneracyOrder(adjacency);
+    std::vector<size_t> position(adjacency.size());
+    for (size_t i = 0; i < order.size(); i++) position[order[i]] = i;
+
+    std::vector<std::vector<size_t>> later(order.size());
+    std::vector<size_t> bound(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        for (size_t to : adjacency[order[i]]) {
+            if (position[to] > i) later[i].push_back(to);
+        }
+        bound[i] = 1 + search.Color(later[i]);
+        search.root_bound = std::max(search.root_bound, bound[i]);
+    }
+
+    /* A greedy clique from the vertex with the largest subproblem, so that there is an answer right away. */
+    if (!order.empty()) {
+        size_t i = std::max_element(bound.begin(), bound.end()) - bound.begin();
+        search.best.push_back(order[i]);
+        for (size_t u : later[i]) {
+            if (std::all_of(search.best.begin(), search.best.end(), [&](size_t x) {
+                return Adjacent(adjacency, u, x);
+            })) {
+                search.best.push_back(u);
+            }
+        }
+    }
+
+    for (size_t i = order.size(); i-- > 0;) {
+        if (monitor.stopped) {
+            search.open_bound = std::max(search.open_bound, bound[i]);
+            continue;
+        }
+        if (bound[i] <= search.best.size()) continue;
+
+        search.clique.assign(1, order[i]);
+        search.Search(later[i]);
+    }
+
+    searchResult<std::vector<size_t>> result;
+    result.best = search.best;
+    result.nodes = monitor.nodes;
+    result.upper_bound = monitor.stopped ? std::max(result.best.size(), search.open_bound) : result.best.size();
+    result.optimal = result.upper_bound == result.best.size();
+    return result;
+}
+
+/**
+ * It searches for a maximum stable set within the budget. The incumbent starts as the greedy stable set that takes
+ * the vertices by increasing degree.
+ *
+ * Returns:
+ *   The best stable set (vertex ids) and the proven upper bound.
+ */
+searchResult<std::vector<size_t>> MaximumStableSetSearch(const std::vector<std::vector<size_t>>& adjacency,
+                                                         const searchBudget& budget) {
+    searchMonitor monitor(budget);
+    stableSetSearch search(adjacency, monitor);
+
+    std::vector<size_t> vertices(adjacency.size());
+    for (size_t v = 0; v < vertices.size(); v++) vertices[v] = v;
+
+    std::vector<size_t> by_degree = vertices;
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&adjacency](size_t lhs, size_t rhs) {
+        return adjacency[lhs].size() < adjacency[rhs].size();
+    });
+
+    membership blocked(adjacency.size());
+    blocked.Clear();
+    for (size_t v : by_degree) {
+        if (blocked.Contains(v)) continue;
+        search.best.push_back(v);
+        blocked.Insert(v);
+        for (size_t to : adjacency[v]) blocked.Insert(to);
+    }
+
+    search.root_bound = search.Bound(vertices);
+    search.Search(vertices);
+
+    searchResult<std::vector<size_t>> result;
+    result.best = search.best;
+    result.nodes = monitor.nodes;
+    result.upper_bound = monitor.stopped
+        ? std::max(result.best.size(), std::min(search.open_bound, search.root_bound))
+        : result.best.size();
+    result.optimal = result.upper_bound == result.best.size();
+    return result;
+}
+
+/**
+ * It searches for a maximum matching within the budget. The incumbent starts as a greedy maximal matching.
+ *
+ * Returns:
+ *   The best matching (pairs of vertex ids) and the proven upper bound.
+ */
+searchResult<std::vector<std::pair<size_t, size_t>>>
+MaximumMatchingSearch(const std::vector<std::vector<size_t>>& adjacency, const searchBudget& budget) {
+    searchMonitor monitor(budget);
+    matchingSearch search(adjacency, monitor);
+
+    std::vector<size_t> vertices(adjacency.size());
+    for (size_t v = 0; v < vertices.size(); v++) vertices[v] = v;
+
+    search.in.Assign(vertices);
+    GreedyMatching(adjacency, vertices, search.in, search.matched, &search.best);
+
+    search.root_bound = std::min(search.Bound(vertices), TutteBound(adjacency));
+    if (search.best.size() < search.root_bound) search.Search(vertices);
+
+    searchResult<std::vector<std::pair<size_t, size_t>>> result;
+    result.best = search.best;
+    result.nodes = monitor.nodes;
+    result.upper_bound = monitor.stopped
+        ? std::max(result.best.size(), std::min(search.open_bound, search.root_bound))
+        : result.best.size();
+    result.optimal = result.upper_bound == result.best.size();
+    return result;
+}
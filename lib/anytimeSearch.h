@@ -0,0 +1,81 @@
+#ifndef GRAPHSOLVER_ANYTIMESEARCH_H
+#define GRAPHSOLVER_ANYTIMESEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+//A snapshot of a running search, passed to the progress callback.
+struct searchProgress {
+    size_t nodes;
+    size_t incumbent;
+    size_t upper_bound;
+    double elapsed_seconds;
+};
+
+//Limits for an exact search. The search stops at whichever limit is hit first and returns the best solution so far.
+struct searchBudget {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    size_t node_limit = SIZE_MAX;
+    const std::atomic<bool>* cancel = nullptr;
+
+    //Called every `progress_interval` search nodes, instead of printing to std::cout.
+    std::function<void(const searchProgress&)> progress;
+    size_t progress_interval = 100000;
+
+    //A budget that expires the given time from now.
+    static searchBudget Within(std::chrono::milliseconds time);
+};
+
+//The outcome of a budgeted search: the best solution found and a proven upper bound on the size of the optimum.
+template <typename Solution>
+struct searchResult {
+    Solution best;
+    size_t upper_bound = 0;
+    size_t nodes = 0;
+    bool optimal = false;
+
+    //The optimality gap: how much larger the optimum can still be than the returned solution.
+    size_t Gap() const { return upper_bound - best.size(); }
+};
+
+//Counts the nodes of a search and decides when it has to stop.
+class searchMonitor {
+public:
+    size_t nodes = 0;
+    bool stopped = false;
+
+    explicit searchMonitor(const searchBudget& budget);
+
+    //Called once per search node; returns true if the search must stop now.
+    bool Stop(size_t incumbent, size_t upper_bound);
+
+private:
+    const searchBudget& budget;
+    std::chrono::steady_clock::time_point start;
+};
+
+//The searches below work on id adjacency lists (sorted, no duplicates, no self-loops), as built by
+//graphSolver::IndexVertices. Each returns the best solution found within the budget and a proven upper bound.
+
+//The vertices in degeneracy order: repeatedly the vertex of minimum remaining degree.
+std::vector<size_t> DegeneracyOrder(const std::vector<std::vector<size_t>>& adjacency);
+
+//Maximum clique by branch and bound with greedy coloring bounds, one subproblem per vertex in degeneracy order.
+searchResult<std::vector<size_t>> MaximumCliqueSearch(const std::vector<std::vector<size_t>>& adjacency,
+                                                      const searchBudget& budget);
+
+//Maximum stable set by branching on the vertex of maximum degree, with degree 0/1 reductions and the bound
+//|candidates| - |maximal matching of the candidates|.
+searchResult<std::vector<size_t>> MaximumStableSetSearch(const std::vector<std::vector<size_t>>& adjacency,
+                                                         const searchBudget& budget);
+
+//Maximum matching by branching on the vertex of minimum degree, with degree 0/1 reductions. The root bound also uses
+//the Tutte-Berge formula with deleted sets of size 0 and 1.
+searchResult<std::vector<std::pair<size_t, size_t>>>
+MaximumMatchingSearch(const std::vector<std::vector<size_t>>& adjacency, const searchBudget& budget);
+
+#endif //GRAPHSOLVER_ANYTIMESEARCH_H
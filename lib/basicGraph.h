@@ -0,0 +1,268 @@
+#ifndef GRAPHSOLVER_BASICGRAPH_H
+#define GRAPHSOLVER_BASICGRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "traversal.h"
+
+//An edge of a basicGraph, used both to build the graph and to return spanning trees.
+template <typename Id, typename Weight>
+struct basicEdge {
+    Id from;
+    Id to;
+    Weight weight;
+};
+
+//This is a compressed sparse row graph whose vertex id width, weight type and directedness are fixed at compile time.
+//Small graphs can use 16-bit ids, which halves the adjacency arrays compared to 32-bit ids.
+template <typename Id = uint32_t, typename Weight = size_t, bool Directed = false>
+class basicGraph {
+    static_assert(std::is_unsigned_v<Id>, "vertex ids must be unsigned integers");
+    static_assert(std::is_arithmetic_v<Weight>, "weights must be integers or floating point numbers");
+
+public:
+    using id_type = Id;
+    using weight_type = Weight;
+    //With 16-bit ids there are less than 2^32 arcs, so 32-bit offsets are enough.
+    using offset_type = std::conditional_t<sizeof(Id) <= 2, uint32_t, size_t>;
+    using edge = basicEdge<Id, Weight>;
+
+    static constexpr bool directed = Directed;
+    static constexpr Id npos = std::numeric_limits<Id>::max();
+
+    //A view of the neighbours of one vertex.
+    struct neighbours {
+        const Id* first;
+        const Id* last;
+
+        const Id* begin() const { return first; }
+        const Id* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    std::vector<std::string> name_of;
+    std::unordered_map<std::string, Id> index_of;
+    std::vector<offset_type> offsets;
+    std::vector<Id> targets;
+    std::vector<Weight> weights;
+
+    size_t size() const { return name_of.size(); }
+
+    size_t ArcCount() const { return targets.size(); }
+
+    size_t EdgeCount() const { return Directed ? targets.size() : targets.size() / 2; }
+
+    bool Weighted() const { return !weights.empty(); }
+
+    neighbours Neighbours(Id v) const {
+        return {targets.data() + offsets[v], targets.data() + offsets[v + 1]};
+    }
+
+    //The weight of the arc stored at position `arc` of `targets`; unweighted graphs have unit weights.
+    Weight WeightOf(size_t arc) const { return weights.empty() ? Weight(1) : weights[arc]; }
+
+    //The id of a vertex, or npos if the graph has no vertex with this name.
+    Id IdOf(const std::string& name) const {
+        auto it = index_of.find(name);
+        return it == index_of.end() ? npos : it->second;
+    }
+
+    static basicGraph Build(std::vector<std::string> names, const std::vector<edge>& edges, bool weighted);
+};
+
+//The default compact graph: 32-bit ids, integer weights, undirected.
+using compactGraph = basicGraph<uint32_t, size_t, false>;
+
+/**
+ * It builds the graph from a list of vertex names and a list of edges between their ids.
+ *
+ * For undirected graphs every edge is stored in both directions. Self-loops are dropped and parallel edges are merged
+ * into the lightest one, so every adjacency row is sorted and free of duplicates.
+ *
+ * Args:
+ *   names (vector<std::string>): the vertex names, the position of a name is its id
+ *   edges (vector<edge>): the edges, `from` and `to` must be ids smaller than names.size()
+ *   weighted (bool): whether the weights of the edges are stored
+ *
+ * Returns:
+ *   The graph. Throws std::length_error if the names do not fit in the id type.
+ */
+template <typename Id, typename Weight, bool Directed>
+basicGraph<Id, Weight, Directed> basicGraph<Id, Weight, Directed>::Build(std::vector<std::string> names,
+                                                                         const std::vector<edge>& edges,
+                                                                         bool weighted) {
+    if (names.size() >= npos) {
+        throw std::length_error("basicGraph: " + std::to_string(names.size()) + " vertices do not fit in the id type");
+    }
+
+    basicGraph g;
+    g.name_of = std::move(names);
+    for (size_t id = 0; id < g.name_of.size(); id++) {
+        g.index_of[g.name_of[id]] = static_cast<Id>(id);
+    }
+
+    /* Collecting the arcs, both directions for undirected graphs, and sorting them by source, target and weight. */
+    std::vector<edge> arcs;
+    arcs.reserve(Directed ? edges.size() : 2 * edges.size());
+    for (const auto& e : edges) {
+        if (e.from == e.to) continue;
+        arcs.push_back(e);
+        if (!Directed) arcs.push_back({e.to, e.from, e.weight});
+    }
+
+    std::sort(arcs.begin(), arcs.end(), [](const edge& lhs, const edge& rhs) {
+        if (lhs.from != rhs.from) return lhs.from < rhs.from;
+        if (lhs.to != rhs.to) return lhs.to < rhs.to;
+        return lhs.weight < rhs.weight;
+    });
+    arcs.erase(std::unique(arcs.begin(), arcs.end(), [](const edge& lhs, const edge& rhs) {
+        return lhs.from == rhs.from && lhs.to == rhs.to;
+    }), arcs.end());
+
+    g.offsets.assign(g.name_of.size() + 1, 0);
+    g.targets.reserve(arcs.size());
+    if (weighted) g.weights.reserve(arcs.size());
+
+    for (const auto& arc : arcs) {
+        g.offsets[arc.from + 1]++;
+        g.targets.push_back(arc.to);
+        if (weighted) g.weights.push_back(arc.weight);
+    }
+
+    std::partial_sum(g.offsets.begin(), g.offsets.end(), g.offsets.begin());
+
+    return g;
+}
+
+/**
+ * It finds the maximum number of hops from the source to any vertex reachable from it, with the direction-optimizing
+ * BFS of traversal.h.
+ *
+ * Args:
+ *   g (Graph): the graph
+ *   source (id_type): the vertex to start from
+ *   threads (size_t): the threads a large BFS level is split over, 0 for one per hardware thread
+ *
+ * Returns:
+ *   The eccentricity of the source within its component.
+ */
+template <typename Graph>
+size_t Eccentricity(const Graph& g, typename Graph::id_type source, size_t threads = 1) {
+    bfsKernel<Graph> bfs(g, threads);
+    bfs.Run(source);
+    return bfs.Depth();
+}
+
+/**
+ * It labels every vertex with the id of its connected component (weakly connected for directed graphs).
+ *
+ * Undirected graphs are labelled with one BFS per component; the kernel only resets what the previous component
+ * reached, so this stays linear. Directed graphs use union-find over the arcs, which ignores their direction.
+ *
+ * Returns:
+ *   A vector of component labels numbered from 0, in order of the smallest vertex of each component.
+ */
+template <typename Graph>
+std::vector<typename Graph::id_type> ConnectedComponents(const Graph& g, size_t threads = 1) {
+    using Id = typename Graph::id_type;
+
+    std::vector<Id> component(g.size(), Graph::npos);
+    Id components = 0;
+
+    if constexpr (!Graph::directed) {
+        bfsKernel<Graph> bfs(g, threads);
+        for (size_t v = 0; v < g.size(); v++) {
+            if (component[v] != Graph::npos) continue;
+            bfs.Run(static_cast<Id>(v));
+            for (Id reached : bfs.Reached()) component[reached] = components;
+            components++;
+        }
+        return component;
+    }
+
+    std::vector<Id> parent(g.size());
+    std::iota(parent.begin(), parent.end(), Id(0));
+
+    auto find = [&parent](Id v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    for (size_t v = 0; v < g.size(); v++) {
+        for (Id to : g.Neighbours(static_cast<Id>(v))) {
+            Id a = find(static_cast<Id>(v));
+            Id b = find(to);
+            if (a != b) parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    for (size_t v = 0; v < g.size(); v++) {
+        Id root = find(static_cast<Id>(v));
+        component[v] = root == v ? components++ : component[root];
+    }
+
+    return component;
+}
+
+/**
+ * It finds a minimum spanning forest of an undirected graph with Kruskal's algorithm.
+ *
+ * Returns:
+ *   The edges of the forest, one spanning tree for every connected component.
+ */
+template <typename Graph>
+std::vector<typename Graph::edge> MinimumSpanningForest(const Graph& g) {
+    static_assert(!Graph::directed, "spanning trees are only defined for undirected graphs");
+    using Id = typename Graph::id_type;
+    using Edge = typename Graph::edge;
+
+    /* Every undirected edge is stored twice, only the copy with from < to is used. */
+    std::vector<Edge> edges;
+    edges.reserve(g.EdgeCount());
+    for (size_t v = 0; v < g.size(); v++) {
+        for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+            if (v < g.targets[arc]) edges.push_back({static_cast<Id>(v), g.targets[arc], g.WeightOf(arc)});
+        }
+    }
+
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) {
+        return lhs.weight < rhs.weight;
+    });
+
+    std::vector<Id> parent(g.size());
+    std::iota(parent.begin(), parent.end(), Id(0));
+
+    auto find = [&parent](Id v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    std::vector<Edge> forest;
+    for (const auto& e : edges) {
+        Id a = find(e.from);
+        Id b = find(e.to);
+        if (a == b) continue;
+
+        parent[a] = b;
+        forest.push_back(e);
+        if (forest.size() + 1 == g.size()) break;
+    }
+
+    return forest;
+}
+
+#endif //GRAPHSOLVER_BASICGRAPH_H
@@ -0,0 +1,335 @@
+#include "batchRunner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "mappedGraph.h"
+
+namespace {
+    void AppendJson(std::string& out, const std::string& text) {
+        out += '"';
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        out += escaped;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    template <typename Names>
+    void AppendJsonArray(std::string& out, const Names& names) {
+        out += '[';
+        bool first = true;
+        for (const auto& name : names) {
+            if (!first) out += ',';
+            first = false;
+            AppendJson(out, name);
+        }
+        out += ']';
+    }
+
+    //Starts the field `name` of an object that already has fields.
+    void AppendKey(std::string& out, const char* name) {
+        out += ",\"";
+        out += name;
+        out += "\":";
+    }
+
+    std::string Trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+    }
+
+    bool IsNumber(const std::string& text) {
+        return !text.empty() && std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(c); });
+    }
+
+    //True if the first line of a text graph has weights: "A, B, w", or "A: B w, ..." where w is a number.
+    bool LooksWeighted(const std::string& line) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            return std::count(line.begin(), line.end(), ',') == 2 && IsNumber(Trim(line.substr(line.rfind(',') + 1)));
+        }
+
+        std::string first = Trim(line.substr(colon + 1, line.find(',', colon) - colon - 1));
+        size_t space = first.rfind(' ');
+        return space != std::string::npos && IsNumber(first.substr(space + 1));
+    }
+
+    void LoadMapped(const std::string& path, graphSolver& g) {
+        mappedGraph mapped(path);
+
+        std::vector<std::string> names(mapped.size());
+        for (uint32_t v = 0; v < mapped.size(); v++) names[v] = mapped.Name(v);
+
+        g.Edit([&](adjacencyMap& graph, weightMap& weights) {
+            for (uint32_t v = 0; v < mapped.size(); v++) {
+                auto& row = graph[names[v]];
+                for (uint64_t arc = mapped.offsets[v]; arc < mapped.offsets[v + 1]; arc++) {
+                    row.push_back(names[mapped.targets[arc]]);
+                    if (mapped.Weighted()) weights[names[v]].push_back(mapped.WeightOf(arc));
+                }
+            }
+        });
+    }
+
+    //Runs the analyses on a loaded graph and appends their fields to the JSON object in `out`.
+    void Solve(graphSolver& g, const batchOptions& options, std::string& out) {
+        g.IndexVertices();
+
+        size_t edges = 0;
+        for (const auto& row : g.adjacency) edges += row.size();
+        AppendKey(out, "vertices");
+        out += std::to_string(g.name_of.size());
+        AppendKey(out, "edges");
+        out += std::to_string(edges / 2);
+        if (g.name_of.empty()) return;
+
+        for (batchAnalysis analysis : options.analyses) {
+            std::string name = BatchAnalysisName(analysis);
+            AppendKey(out, name.c_str());
+
+            switch (analysis) {
+                case batchAnalysis::radius:
+                case batchAnalysis::diameter: {
+                    auto [country, value] = analysis == batchAnalysis::radius ? g.FindRadius() : g.FindDiameter();
+                    out += "{\"country\":";
+                    AppendJson(out, country);
+                    out += ",\"value\":" + std::to_string(value) + "}";
+                    break;
+                }
+                case batchAnalysis::center:
+                    AppendJsonArray(out, g.FindCenter());
+                    break;
+                case batchAnalysis::clique:
+                case batchAnalysis::stable_set: {
+                    auto budget = searchBudget::Within(options.search_time);
+                    auto result = analysis == batchAnalysis::clique ? g.Bronkerbosch(budget)
+                                                                    : g.FindMaximumStableSet(budget);
+                    out += "{\"size\":" + std::to_string(result.best.size()) + ",\"optimal\":" +
+                           (result.optimal ? "true" : "false") + ",\"vertices\":";
+                    AppendJsonArray(out, result.best);
+                    out += '}';
+                    break;
+                }
+                case batchAnalysis::vertex_cover: {
+                    auto result = g.FindMinimumVertexCover(searchBudget::Within(options.search_time));
+                    out += "{\"size\":" + std::to_string(result.best.size()) + ",\"optimal\":" +
+                           (result.optimal ? "true" : "false") + ",\"vertices\":";
+                    AppendJsonArray(out, result.best);
+                    out += '}';
+                    break;
+                }
+                case batchAnalysis::matching: {
+                    auto result = g.FindMaximumMatching(searchBudget::Within(options.search_time));
+                    out += "{\"size\":" + std::to_string(result.best.size()) + ",\"optimal\":" +
+                           (result.optimal ? "true" : "false") + ",\"edges\":[";
+                    for (size_t i = 0; i < result.best.size(); i++) {
+                        if (i) out += ',';
+                        AppendJsonArray(out, std::vector<std::string>{result.best[i].first, result.best[i].second});
+                    }
+                    out += "]}";
+                    break;
+                }
+                case batchAnalysis::spanning_tree: {
+                    spanningTree tree = g.FindMinimumSpanningTree();
+                    size_t weight = 0;
+                    for (const auto& [connected, cost] : tree) weight += cost;
+                    out += "{\"edges\":" + std::to_string(tree.size()) + ",\"weight\":" + std::to_string(weight) + "}";
+                    break;
+                }
+                case batchAnalysis::postman: {
+                    postmanWalk walk = g.FindPostmanWalk(searchBudget::Within(options.search_time));
+                    out += "{\"length\":" + std::to_string(walk.length) + ",\"repeated\":" +
+                           std::to_string(walk.repeated) + ",\"optimal\":" + (walk.optimal ? "true" : "false") + "}";
+                    break;
+                }
+            }
+        }
+    }
+}
+
+batchAnalysis ParseBatchAnalysis(const std::string& name) {
+    for (auto analysis : {batchAnalysis::radius, batchAnalysis::diameter, batchAnalysis::center,
+                          batchAnalysis::clique, batchAnalysis::stable_set, batchAnalysis::vertex_cover,
+                          batchAnalysis::matching, batchAnalysis::spanning_tree, batchAnalysis::postman}) {
+        if (BatchAnalysisName(analysis) == name) return analysis;
+    }
+    throw std::invalid_argument("unknown analysis " + name);
+}
+
+std::string BatchAnalysisName(batchAnalysis analysis) {
+    switch (analysis) {
+        case batchAnalysis::radius: return "radius";
+        case batchAnalysis::diameter: return "diameter";
+        case batchAnalysis::center: return "center";
+        case batchAnalysis::clique: return "clique";
+        case batchAnalysis::stable_set: return "stable_set";
+        case batchAnalysis::vertex_cover: return "vertex_cover";
+        case batchAnalysis::matching: return "matching";
+        case batchAnalysis::spanning_tree: return "spanning_tree";
+        case batchAnalysis::postman: return "postman";
+    }
+    return "";
+}
+
+std::vector<std::string> BatchInputs(const std::string& path) {
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> files;
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::directory_iterator(path)) {
+            if (entry.is_regular_file()) files.push_back(entry.path().string());
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    std::ifstream manifest(path);
+    if (!manifest) throw std::runtime_error("cannot read " + path);
+
+    fs::path base = fs::path(path).parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+        line = Trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        fs::path file(line);
+        files.push_back((file.is_absolute() ? file : base / file).string());
+    }
+    return files;
+}
+
+void LoadGraphFile(const std::string& path, graphSolver& g) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("cannot read " + path);
+
+    g.Clear();
+
+    char header[8] = {};
+    file.read(header, sizeof(header));
+    if (file.gcount() == sizeof(header) && std::memcmp(header, "GSCSR01", sizeof(header)) == 0) {
+        file.close();
+        LoadMapped(path, g);
+        return;
+    }
+
+    file.clear();
+    file.seekg(0);
+    std::string line;
+    while (std::getline(file, line)) {
+        line = Trim(line);
+        if (!line.empty() && line[0] != '#') break;
+    }
+    bool weighted = LooksWeighted(line);
+
+    file.clear();
+    file.seekg(0);
+    if (weighted) {
+        g.LoadWeighted(file);
+    } else {
+        file >> g;
+    }
+}
+
+/**
+ * It hands the files to the threads one at a time. Every thread keeps one graphSolver and one output buffer for all
+ * its files, so a file costs no thread start, and the hash tables and the buffer keep the capacity they grew to. A
+ * line that finishes before the lines above it is kept until they are written.
+ *
+ * Args:
+ *   files (vector<string>): the graph files
+ *   options (batchOptions): the analyses, the thread count and the search budget
+ *   out (ostream): where the JSON lines go
+ *
+ * Returns:
+ *   The number of graphs, how many failed, and the wall time.
+ */
+batchSummary RunBatch(const std::vector<std::string>& files, const batchOptions& options, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+
+    size_t threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, files.size()));
+
+    std::vector<std::string> lines(files.size());
+    std::vector<bool> finished(files.size(), false);
+    size_t next_to_write = 0;
+    size_t failed = 0;
+    std::mutex lock;
+    std::atomic<size_t> next_file{0};
+
+    auto worker = [&]() {
+        graphSolver g;
+        g.use_cache = false;
+        g.threads = 1;      /* the files already run in parallel */
+        std::string line;
+
+        for (size_t i = next_file++; i < files.size(); i = next_file++) {
+            auto graph_start = std::chrono::steady_clock::now();
+            bool ok = true;
+
+            line = "{\"file\":";
+            AppendJson(line, files[i]);
+            try {
+                LoadGraphFile(files[i], g);
+                Solve(g, options, line);
+            } catch (const std::exception& error) {
+                ok = false;
+                line = "{\"file\":";
+                AppendJson(line, files[i]);
+                AppendKey(line, "error");
+                AppendJson(line, error.what());
+            }
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - graph_start;
+            AppendKey(line, "seconds");
+            line += std::to_string(elapsed.count());
+            line += '}';
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (!ok) failed++;
+
+            /* Only a line that has to wait is copied; the buffer itself stays with the thread. */
+            if (i != next_to_write) {
+                lines[i] = line;
+                finished[i] = true;
+                continue;
+            }
+
+            out << line << '\n';
+            for (next_to_write++; next_to_write < files.size() && finished[next_to_write]; next_to_write++) {
+                out << lines[next_to_write] << '\n';
+                std::string().swap(lines[next_to_write]);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; i++) pool.emplace_back(worker);
+    if (!files.empty()) worker();
+    for (auto& thread : pool) thread.join();
+    out.flush();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return {files.size(), failed, elapsed.count()};
+}
@@ -0,0 +1,66 @@
+#ifndef GRAPHSOLVER_BATCHRUNNER_H
+#define GRAPHSOLVER_BATCHRUNNER_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "graphSolver.h"
+
+//The analyses a batch can run on every graph.
+enum class batchAnalysis {
+    radius,
+    diameter,
+    center,
+    clique,
+    stable_set,
+    vertex_cover,
+    matching,
+    spanning_tree,
+    postman
+};
+
+//Throws std::invalid_argument for an unknown name; the names are the enumerator names.
+batchAnalysis ParseBatchAnalysis(const std::string& name);
+
+std::string BatchAnalysisName(batchAnalysis analysis);
+
+struct batchOptions {
+    std::vector<batchAnalysis> analyses = {batchAnalysis::radius, batchAnalysis::diameter, batchAnalysis::center,
+                                           batchAnalysis::clique, batchAnalysis::stable_set, batchAnalysis::matching,
+                                           batchAnalysis::spanning_tree};
+    size_t threads = 0;                                     //0 for one per hardware thread
+    std::chrono::milliseconds search_time{1000};            //the budget of each clique, stable set and matching search
+};
+
+//What a batch did.
+struct batchSummary {
+    size_t graphs = 0;
+    size_t failed = 0;
+    double elapsed_seconds = 0;
+};
+
+/**
+ * It lists the graph files of a batch: the regular files of a directory in name order, or the lines of a manifest
+ * file (empty lines and lines starting with '#' are skipped, and relative paths are relative to the manifest).
+ *
+ * Returns:
+ *   The paths. Throws std::runtime_error if the path cannot be read.
+ */
+std::vector<std::string> BatchInputs(const std::string& path);
+
+/**
+ * It reads one graph file into `g`, replacing its graph. The format is recognized from the content:
+ *   - a mappedGraph file (it starts with the magic "GSCSR01"),
+ *   - a weighted text graph as read by LoadWeighted, if the first line is "A, B, w" or "A: B w, C w",
+ *   - otherwise an adjacency list "A: B, C" as read by operator>>.
+ * Throws std::runtime_error if the file cannot be read.
+ */
+void LoadGraphFile(const std::string& path, graphSolver& g);
+
+//Solves every file on a pool of threads and writes one JSON object per line, in the order of `files`. A graph that
+//fails to load or to solve gets a line with "error" instead of the results; the others are not affected.
+batchSummary RunBatch(const std::vector<std::string>& files, const batchOptions& options, std::ostream& out);
+
+#endif //GRAPHSOLVER_BATCHRUNNER_H
@@ -0,0 +1,245 @@
+#ifndef GRAPHSOLVER_DENSEGRAPH_H
+#define GRAPHSOLVER_DENSEGRAPH_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//The largest graph the dense backend takes.
+constexpr size_t dense_graph_limit = 512;
+
+//A fixed-width bitset of Words 64-bit words. The loops have a compile-time trip count, so the compiler unrolls them
+//and keeps a whole set in (vector) registers.
+template <size_t Words>
+struct denseBitset {
+    std::array<uint64_t, Words> word{};
+
+    void Set(size_t v) { word[v / 64] |= uint64_t(1) << (v % 64); }
+
+    void Reset(size_t v) { word[v / 64] &= ~(uint64_t(1) << (v % 64)); }
+
+    bool Test(size_t v) const { return word[v / 64] >> (v % 64) & 1; }
+
+    bool Any() const {
+        uint64_t any = 0;
+        for (size_t i = 0; i < Words; i++) any |= word[i];
+        return any != 0;
+    }
+
+    size_t Count() const {
+        size_t count = 0;
+        for (size_t i = 0; i < Words; i++) count += __builtin_popcountll(word[i]);
+        return count;
+    }
+
+    //The smallest element; the set must not be empty.
+    size_t First() const {
+        size_t i = 0;
+        while (!word[i]) i++;
+        return i * 64 + __builtin_ctzll(word[i]);
+    }
+
+    denseBitset operator&(const denseBitset& other) const {
+        denseBitset result;
+        for (size_t i = 0; i < Words; i++) result.word[i] = word[i] & other.word[i];
+        return result;
+    }
+
+    denseBitset& AndNot(const denseBitset& other) {
+        for (size_t i = 0; i < Words; i++) word[i] &= ~other.word[i];
+        return *this;
+    }
+
+    //Calls visit(v) for every element in increasing order.
+    template <typename Visitor>
+    void ForEach(Visitor&& visit) const {
+        for (size_t i = 0; i < Words; i++) {
+            for (uint64_t bits = word[i]; bits; bits &= bits - 1) visit(i * 64 + __builtin_ctzll(bits));
+        }
+    }
+};
+
+//This is the backend for small graphs: the adjacency matrix as one bitset row per vertex, with the width fixed at
+//compile time by the size class (64, 128, 256 or 512 vertices). Neighbourhood intersections are a handful of word
+//operations, and the exact searches below allocate nothing while they branch.
+template <size_t MaxVertices>
+class denseGraph {
+    static_assert(MaxVertices == 64 || MaxVertices == 128 || MaxVertices == 256 || MaxVertices == 512,
+                  "the size classes are 64, 128, 256 and 512 vertices");
+
+public:
+    static constexpr size_t words = MaxVertices / 64;
+    using bitset = denseBitset<words>;
+
+    //Builds the matrix from id adjacency lists (as built by graphSolver::IndexVertices).
+    explicit denseGraph(const std::vector<std::vector<size_t>>& adjacency);
+
+    size_t size() const { return n; }
+
+    bool Adjacent(size_t u, size_t v) const { return rows[u].Test(v); }
+
+    denseGraph Complement() const;
+
+    //Maximum clique by branch and bound with greedy coloring bounds, computed on bitsets (San Segundo's BBMC).
+    std::vector<size_t> MaximumClique() const;
+
+    //A maximum clique of the complement.
+    std::vector<size_t> MaximumStableSet() const { return Complement().MaximumClique(); }
+
+    //The vertices outside a maximum stable set.
+    std::vector<size_t> MinimumVertexCover() const;
+
+private:
+    size_t n = 0;
+    std::vector<bitset> rows;
+
+    denseGraph() = default;
+
+    //The search state: the vertices are renumbered by decreasing degree, so that the coloring meets the
+    //well-connected vertices first.
+    struct cliqueSearch {
+        std::vector<bitset> rows;
+        std::vector<size_t> current;
+        std::vector<size_t> best;
+
+        void Expand(bitset candidates);
+    };
+};
+
+template <size_t MaxVertices>
+denseGraph<MaxVertices>::denseGraph(const std::vector<std::vector<size_t>>& adjacency) : n(adjacency.size()) {
+    if (n > MaxVertices) {
+        throw std::length_error("denseGraph: " + std::to_string(n) + " vertices do not fit in " +
+                                std::to_string(MaxVertices));
+    }
+
+    rows.assign(n, bitset());
+    for (size_t u = 0; u < n; u++) {
+        for (size_t v : adjacency[u]) {
+            if (u == v) continue;
+            rows[u].Set(v);
+            rows[v].Set(u);
+        }
+    }
+}
+
+template <size_t MaxVertices>
+denseGraph<MaxVertices> denseGraph<MaxVertices>::Complement() const {
+    denseGraph complement;
+    complement.n = n;
+    complement.rows.assign(n, bitset());
+
+    for (size_t u = 0; u < n; u++) {
+        for (size_t v = 0; v < n; v++) {
+            if (u != v && !rows[u].Test(v)) complement.rows[u].Set(v);
+        }
+    }
+    return complement;
+}
+
+/**
+ * It colors the candidates greedily, one color class at a time: a class takes the first remaining candidate and then
+ * every remaining candidate that is adjacent to none of the class so far. A clique has at most one vertex of every
+ * color, so the branches are tried from the last color down and pruned as soon as the color cannot beat the best.
+ */
+template <size_t MaxVertices>
+void denseGraph<MaxVertices>::cliqueSearch::Expand(bitset candidates) {
+    std::array<uint16_t, MaxVertices> order;
+    std::array<uint16_t, MaxVertices> color;
+    size_t count = 0;
+
+    bitset uncolored = candidates;
+    for (uint16_t k = 1; uncolored.Any(); k++) {
+        bitset available = uncolored;
+        while (available.Any()) {
+            size_t v = available.First();
+            available.Reset(v);
+            available.AndNot(rows[v]);
+            uncolored.Reset(v);
+
+            order[count] = static_cast<uint16_t>(v);
+            color[count++] = k;
+        }
+    }
+
+    while (count--) {
+        if (current.size() + color[count] <= best.size()) return;
+
+        size_t v = order[count];
+        current.push_back(v);
+
+        bitset next = candidates & rows[v];
+        if (next.Any()) {
+            Expand(next);
+        } else if (current.size() > best.size()) {
+            best = current;
+        }
+
+        current.pop_back();
+        candidates.Reset(v);
+    }
+}
+
+template <size_t MaxVertices>
+std::vector<size_t> denseGraph<MaxVertices>::MaximumClique() const {
+    std::vector<size_t> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(), [this](size_t lhs, size_t rhs) {
+        return rows[lhs].Count() > rows[rhs].Count();
+    });
+
+    std::vector<size_t> new_id(n);
+    for (size_t i = 0; i < n; i++) new_id[by_degree[i]] = i;
+
+    cliqueSearch search;
+    search.rows.assign(n, bitset());
+    bitset all;
+    for (size_t i = 0; i < n; i++) {
+        rows[by_degree[i]].ForEach([&](size_t v) { search.rows[i].Set(new_id[v]); });
+        all.Set(i);
+    }
+
+    if (n) search.Expand(all);
+
+    std::vector<size_t> clique;
+    for (size_t v : search.best) clique.push_back(by_degree[v]);
+    std::sort(clique.begin(), clique.end());
+    return clique;
+}
+
+template <size_t MaxVertices>
+std::vector<size_t> denseGraph<MaxVertices>::MinimumVertexCover() const {
+    std::vector<bool> stable(n, false);
+    for (size_t v : MaximumStableSet()) stable[v] = true;
+
+    std::vector<size_t> cover;
+    for (size_t v = 0; v < n; v++) {
+        if (!stable[v]) cover.push_back(v);
+    }
+    return cover;
+}
+
+/**
+ * It builds the dense graph of the smallest size class that fits the graph and passes it to `visit`.
+ *
+ * Args:
+ *   adjacency (vector<vector<size_t>>): the id adjacency lists
+ *   visit (Visitor): called with a denseGraph<64>, denseGraph<128>, denseGraph<256> or denseGraph<512>
+ *
+ * Returns:
+ *   The result of visit. Throws std::length_error for graphs with more than 512 vertices.
+ */
+template <typename Visitor>
+auto WithDenseGraph(const std::vector<std::vector<size_t>>& adjacency, Visitor&& visit) {
+    size_t n = adjacency.size();
+    if (n <= 64) return visit(denseGraph<64>(adjacency));
+    if (n <= 128) return visit(denseGraph<128>(adjacency));
+    if (n <= 256) return visit(denseGraph<256>(adjacency));
+    return visit(denseGraph<512>(adjacency));
+}
+
+#endif //GRAPHSOLVER_DENSEGRAPH_H
@@ -0,0 +1,298 @@
+#include "distanceOracle.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    const char magic[8] = "GSDIST1";
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    void NameIndex(const compactGraph& g, std::vector<std::string>& name_of,
+                   std::unordered_map<std::string, uint32_t>& index_of) {
+        name_of = g.name_of;
+        index_of.clear();
+        for (uint32_t v = 0; v < name_of.size(); v++) index_of[name_of[v]] = v;
+    }
+
+    //The bytes of the table laid out by distanceOracle::Layout, without allocating it.
+    uint64_t CellBytes(uint64_t n, unsigned bits) {
+        uint64_t total = 0;
+        for (uint64_t a = 0; a < n; a++) {
+            if (bits == 4) total += total & 1;
+            total += n - a - 1;
+        }
+        return bits == 8 ? total : (total + 1) / 2;
+    }
+}
+
+void distanceOracle::Layout(size_t n) {
+    row_start.assign(n, 0);
+    uint64_t total = 0;
+    for (size_t a = 0; a < n; a++) {
+        if (bits == 4) total += total & 1;
+        row_start[a] = total;
+        total += n - a - 1;
+    }
+    cells.assign(bits == 8 ? total : (total + 1) / 2, 0);
+}
+
+size_t distanceOracle::MemoryUsage() const {
+    return cells.capacity() + row_start.capacity() * sizeof(uint64_t);
+}
+
+/**
+ * It builds the table with one BFS per vertex. The threads take the sources one by one, each with its own
+ * single-threaded kernel, and every row starts on a whole byte, so no two threads write the same byte.
+ *
+ * The cell width is chosen before the BFS runs: twice the eccentricity of one vertex per component bounds the
+ * diameter of that component, and 4 bits are used when that bound is below 15.
+ *
+ * Args:
+ *   g (compactGraph): the graph; the weights are ignored
+ *   threads (size_t): the number of threads, 0 for one per hardware thread
+ *
+ * Returns:
+ *   The oracle.
+ */
+distanceOracle distanceOracle::Build(const compactGraph& g, size_t threads) {
+    static_assert(!compactGraph::directed, "the table is symmetric");
+
+    distanceOracle oracle;
+    NameIndex(g, oracle.name_of, oracle.index_of);
+    size_t n = g.size();
+
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, n));
+
+    bfsKernel<compactGraph> bfs(g, threads);
+    std::vector<bool> seen(n, false);
+    uint32_t bound = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        if (seen[v]) continue;
+        bfs.Run(v);
+        for (uint32_t u : bfs.Reached()) seen[u] = true;
+        bound = std::max(bound, 2 * bfs.Depth());
+    }
+
+    oracle.bits = bound < 15 ? 4 : 8;
+    oracle.Layout(n);
+
+    std::atomic<uint32_t> next_source{0};
+    std::atomic<bool> too_far{false};
+
+    auto worker = [&]() {
+        bfsKernel<compactGraph> local(g);
+        uint32_t missing = oracle.Missing();
+
+        for (uint32_t a = next_source++; a < n; a = next_source++) {
+            local.Run(a);
+
+            for (uint32_t b = a + 1; b < n; b++) {
+                uint32_t d = local.Distance(b);
+                if (d != none && d >= missing) too_far = true;
+                uint32_t value = d == none ? missing : std::min(d, missing);
+
+                uint64_t cell = oracle.row_start[a] + (b - a - 1);
+                if (oracle.bits == 8) {
+                    oracle.cells[cell] = static_cast<uint8_t>(value);
+                } else {
+                    oracle.cells[cell >> 1] |= static_cast<uint8_t>(value << ((cell & 1) * 4));
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    if (too_far) {
+        throw std::length_error("distanceOracle: some distance is 255 hops or more, use landmarkOracle");
+    }
+
+    return oracle;
+}
+
+void distanceOracle::Save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("distanceOracle: cannot write " + path);
+
+    auto write_u64 = [&out](uint64_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    out.write(magic, sizeof(magic));
+    write_u64(size());
+    write_u64(bits);
+    write_u64(cells.size());
+    out.write(reinterpret_cast<const char*>(cells.data()), cells.size());
+
+    std::string names;
+    for (size_t v = 0; v < size(); v++) {
+        if (v) names += '\n';
+        names += name_of[v];
+    }
+    write_u64(names.size());
+    out.write(names.data(), names.size());
+
+    if (!out) throw std::runtime_error("distanceOracle: cannot write " + path);
+}
+
+/**
+ * It reads a table written by Save.
+ *
+ * Args:
+ *   path (string): the file
+ *
+ * Returns:
+ *   The oracle. Throws std::runtime_error if the file is not a distance table, or if its sizes do not match its length,
+ *   before allocating anything for them.
+ */
+distanceOracle distanceOracle::Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("distanceOracle: cannot open " + path);
+
+    uint64_t length = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+    auto remaining = [&in, length]() { return length - static_cast<uint64_t>(in.tellg()); };
+
+    auto read_u64 = [&in, &path]() {
+        uint64_t value;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+            throw std::runtime_error("distanceOracle: " + path + " is truncated");
+        }
+        return value;
+    };
+
+    char header[sizeof(magic)];
+    if (!in.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic)) {
+        throw std::runtime_error("distanceOracle: " + path + " is not a distance table");
+    }
+
+    distanceOracle oracle;
+    uint64_t n = read_u64();
+    oracle.bits = static_cast<unsigned>(read_u64());
+    if (oracle.bits != 4 && oracle.bits != 8) {
+        throw std::runtime_error("distanceOracle: " + path + " is not a distance table");
+    }
+
+    /* Every vertex but the first takes at least a separator in the names, which bounds n by the file length. */
+    uint64_t cell_bytes = read_u64();
+    if (n > std::numeric_limits<uint32_t>::max() || n > remaining() || cell_bytes != CellBytes(n, oracle.bits)) {
+        throw std::runtime_error("distanceOracle: " + path + " is corrupt");
+    }
+    if (cell_bytes + sizeof(uint64_t) > remaining()) {
+        throw std::runtime_error("distanceOracle: " + path + " is truncated");
+    }
+
+    oracle.Layout(n);
+    in.read(reinterpret_cast<char*>(oracle.cells.data()), oracle.cells.size());
+
+    uint64_t names_length = read_u64();
+    if (names_length > remaining()) throw std::runtime_error("distanceOracle: " + path + " is truncated");
+    if (names_length < remaining()) throw std::runtime_error("distanceOracle: " + path + " is corrupt");
+
+    std::string names(names_length, '\0');
+    if (!in.read(names.data(), names.size())) throw std::runtime_error("distanceOracle: " + path + " is truncated");
+    uint64_t separators = std::count(names.begin(), names.end(), '\n');
+    if (n == 0 ? !names.empty() : separators + 1 != n) {
+        throw std::runtime_error("distanceOracle: " + path + " is corrupt");
+    }
+
+    size_t begin = 0;
+    for (uint64_t v = 0; v < n; v++) {
+        size_t end = std::min(names.find('\n', begin), names.size());
+        oracle.name_of.push_back(names.substr(begin, end - begin));
+        oracle.index_of[oracle.name_of.back()] = static_cast<uint32_t>(v);
+        begin = end + 1;
+    }
+
+    return oracle;
+}
+
+size_t landmarkOracle::Distance(uint32_t a, uint32_t b) const {
+    if (a == b) return 0;
+
+    size_t k = landmarks.size();
+    const uint32_t* from_a = dist.data() + a * k;
+    const uint32_t* from_b = dist.data() + b * k;
+
+    size_t best = unreachable;
+    for (size_t i = 0; i < k; i++) {
+        if (from_a[i] == none || from_b[i] == none) continue;
+        best = std::min<size_t>(best, size_t(from_a[i]) + from_b[i]);
+    }
+    return best;
+}
+
+size_t landmarkOracle::LowerBound(uint32_t a, uint32_t b) const {
+    size_t k = landmarks.size();
+    const uint32_t* from_a = dist.data() + a * k;
+    const uint32_t* from_b = dist.data() + b * k;
+
+    size_t bound = 0;
+    for (size_t i = 0; i < k; i++) {
+        /* A landmark that reaches only one of them proves that they are in different components. */
+        if ((from_a[i] == none) != (from_b[i] == none)) return unreachable;
+        if (from_a[i] == none) continue;
+        bound = std::max<size_t>(bound, from_a[i] > from_b[i] ? from_a[i] - from_b[i] : from_b[i] - from_a[i]);
+    }
+    return bound;
+}
+
+/**
+ * It chooses the landmarks and stores their distances to every vertex, with one BFS per landmark.
+ *
+ * Args:
+ *   g (compactGraph): the graph; the weights are ignored
+ *   count (size_t): the number of landmarks, at most the number of vertices
+ *   threads (size_t): the threads a large BFS level is split over, 0 for one per hardware thread
+ *
+ * Returns:
+ *   The oracle.
+ */
+landmarkOracle landmarkOracle::Build(const compactGraph& g, size_t count, size_t threads) {
+    landmarkOracle oracle;
+    NameIndex(g, oracle.name_of, oracle.index_of);
+
+    size_t n = g.size();
+    count = std::min(count, n);
+    if (!count) return oracle;
+
+    oracle.dist.assign(n * count, none);
+
+    /* The distance from every vertex to its nearest landmark so far; none until a landmark reaches it. */
+    std::vector<uint32_t> nearest(n, none);
+    bfsKernel<compactGraph> bfs(g, threads);
+
+    uint32_t next = 0;
+    for (uint32_t v = 1; v < n; v++) {
+        if (g.Neighbours(v).size() > g.Neighbours(next).size()) next = v;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        oracle.landmarks.push_back(next);
+        bfs.Run(next);
+
+        for (uint32_t v : bfs.Reached()) {
+            oracle.dist[v * count + i] = bfs.Distance(v);
+            nearest[v] = std::min(nearest[v], bfs.Distance(v));
+        }
+
+        /* The farthest vertex from all landmarks, where unreached vertices count as infinitely far. */
+        uint32_t farthest = 0;
+        for (uint32_t v = 1; v < n; v++) {
+            bool farther = nearest[v] == none ? nearest[farthest] != none || g.Neighbours(v).size() >
+                                                g.Neighbours(farthest).size()
+                                              : nearest[farthest] != none && nearest[v] > nearest[farthest];
+            if (farther) farthest = v;
+        }
+        next = farthest;
+    }
+
+    return oracle;
+}
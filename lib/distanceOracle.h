@@ -0,0 +1,100 @@
+#ifndef GRAPHSOLVER_DISTANCEORACLE_H
+#define GRAPHSOLVER_DISTANCEORACLE_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "basicGraph.h"
+
+//The exact hop distance between every pair of vertices of an undirected graph, precomputed so that a query is one
+//memory read. Only the upper triangle is stored, with 4 bits per pair when every distance is below 15 and 8 bits
+//otherwise, so a graph with 20000 vertices takes 100-200 MB.
+class distanceOracle {
+public:
+    static constexpr size_t unreachable = std::numeric_limits<size_t>::max();
+
+    std::vector<std::string> name_of;
+    std::unordered_map<std::string, uint32_t> index_of;
+
+    size_t size() const { return name_of.size(); }
+
+    //The bits per pair, 4 or 8.
+    unsigned CellBits() const { return bits; }
+
+    size_t MemoryUsage() const;
+
+    size_t Distance(uint32_t a, uint32_t b) const {
+        if (a == b) return 0;
+        if (a > b) std::swap(a, b);
+
+        uint64_t cell = row_start[a] + (b - a - 1);
+        unsigned value = bits == 8 ? cells[cell] : (cells[cell >> 1] >> ((cell & 1) * 4)) & 0xf;
+        return value == Missing() ? unreachable : value;
+    }
+
+    //Throws std::out_of_range for an unknown country.
+    size_t Distance(const std::string& a, const std::string& b) const {
+        return Distance(index_of.at(a), index_of.at(b));
+    }
+
+    //Runs a BFS from every vertex on `threads` threads (0 means one per hardware thread). Throws std::length_error
+    //if some distance is 255 hops or more; use landmarkOracle for such graphs.
+    static distanceOracle Build(const compactGraph& g, size_t threads = 0);
+
+    //The file holds the magic "GSDIST1", the vertex count, the cell bits and the cell byte count (8 bytes each),
+    //the cells, and the names like a mappedGraph file.
+    void Save(const std::string& path) const;
+
+    static distanceOracle Load(const std::string& path);
+
+private:
+    unsigned bits = 8;
+    std::vector<uint64_t> row_start;
+    std::vector<uint8_t> cells;
+
+    unsigned Missing() const { return (1u << bits) - 1; }
+
+    //Lays out the rows for `bits`: row a holds the pairs (a, b > a) and starts on a whole byte.
+    void Layout(size_t n);
+};
+
+//An approximate distance oracle for graphs too large for the full table: the hop distances from a few landmarks to
+//every vertex. A query combines them through the triangle inequality in O(landmarks) time.
+class landmarkOracle {
+public:
+    static constexpr size_t unreachable = std::numeric_limits<size_t>::max();
+
+    std::vector<std::string> name_of;
+    std::unordered_map<std::string, uint32_t> index_of;
+
+    size_t size() const { return name_of.size(); }
+
+    const std::vector<uint32_t>& Landmarks() const { return landmarks; }
+
+    //An upper bound, the shortest path through a landmark. It is exact when a shortest path passes a landmark, and
+    //unreachable if no landmark reaches both vertices.
+    size_t Distance(uint32_t a, uint32_t b) const;
+
+    //A lower bound, the largest difference of the distances to a landmark.
+    size_t LowerBound(uint32_t a, uint32_t b) const;
+
+    size_t Distance(const std::string& a, const std::string& b) const {
+        return Distance(index_of.at(a), index_of.at(b));
+    }
+
+    //Picks the landmarks farthest first: the highest degree vertex, then every time the vertex farthest from the
+    //landmarks chosen so far, preferring vertices they do not reach, so every component gets one if there are enough.
+    //The levels of every landmark BFS are split over `threads`, 0 for one per hardware thread.
+    static landmarkOracle Build(const compactGraph& g, size_t count = 16, size_t threads = 0);
+
+private:
+    std::vector<uint32_t> landmarks;
+    //dist[v * landmarks + i] is the distance from landmark i to v, so a query reads two contiguous runs.
+    std::vector<uint32_t> dist;
+};
+
+#endif //GRAPHSOLVER_DISTANCEORACLE_H
@@ -1,8 +1,70 @@
 #include "graphSolver.h"
 
 #include <algorithm>
+#include <charconv>
+#include <climits>
 #include <iostream>
-#include <queue>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+
+namespace {
+    /* The cached results are stored as lines of text. */
+    std::string JoinLines(const std::vector<std::string>& lines) {
+        std::string joined;
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (i) joined += '\n';
+            joined += lines[i];
+        }
+        return joined;
+    }
+
+    std::vector<std::string> SplitLines(const std::string& joined) {
+        std::vector<std::string> lines;
+        if (joined.empty()) return lines;
+
+        std::istringstream stream(joined);
+        std::string line;
+        while (std::getline(stream, line)) lines.push_back(line);
+        if (joined.back() == '\n') lines.emplace_back();
+        return lines;
+    }
+
+    std::string SerializeTree(const spanningTree& tree) {
+        std::vector<std::string> lines;
+        for (const auto& [connected, cost] : tree) {
+            lines.push_back(connected.first + '\t' + connected.second + '\t' + std::to_string(cost));
+        }
+        return JoinLines(lines);
+    }
+
+    std::string_view Trim(std::string_view text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) return {};
+        return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+    }
+
+    /* The weights are non-negative integers, parsed without the locale and the allocations of a stringstream. */
+    bool ParseWeight(std::string_view text, size_t& weight) {
+        text = Trim(text);
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), weight);
+        return !text.empty() && error == std::errc() && end == text.data() + text.size();
+    }
+
+    spanningTree DeserializeTree(const std::string& text) {
+        spanningTree tree;
+        for (const auto& line : SplitLines(text)) {
+            size_t first_tab = line.find('\t');
+            size_t second_tab = line.find('\t', first_tab + 1);
+            tree.push_back({{line.substr(0, first_tab), line.substr(first_tab + 1, second_tab - first_tab - 1)},
+                            std::stoull(line.substr(second_tab + 1))});
+        }
+        return tree;
+    }
+}
 
 /**
  * It reads a line from the input stream, parses it, and adds the parsed data to the graph
@@ -38,11 +100,317 @@ std::istream& operator>>(std::istream& stream, graphSolver& g) {
         to.push_back(country);
 
         g.graph[from] = to;
+        g.weights.erase(from);
     }
 
+    g.version++;
+
     return stream;
 }
 
+/**
+ * It reads a weighted graph in one pass and replaces the graph and its weights with it.
+ *
+ * Every line is either an edge, "A, B, w", or a weighted adjacency line, "A: B w, C w", where the weight is the last
+ * word of every neighbour. Empty lines and lines starting with '#' are skipped. Country names are interned while
+ * reading, so the edges are kept as pairs of ids until the rows of `graph` and `weights` are built.
+ *
+ * An edge may be listed in both directions, as adjacency lines do. Duplicates in the same direction, different weights
+ * for the two directions and self-loops are reported; the lightest weight of an edge is kept and self-loops are dropped.
+ *
+ * Args:
+ *   stream (istream): the weighted graph
+ *
+ * Returns:
+ *   The report of the load. Throws std::runtime_error for a malformed line.
+ */
+loadReport graphSolver::LoadWeighted(std::istream& stream) {
+    PROFILE_ALLOCATIONS("graphSolver::LoadWeighted");
+
+    struct listedArc {
+        uint32_t from;
+        uint32_t to;
+        size_t weight;
+        size_t line;
+    };
+
+    const size_t max_problems = 100;
+
+    loadReport report;
+    std::unordered_map<std::string, uint32_t> id;
+    std::vector<const std::string*> names;
+    std::vector<listedArc> arcs;
+
+    auto malformed = [&report](const std::string& line) {
+        return std::runtime_error("graphSolver: line " + std::to_string(report.lines) + " is not a weighted edge: \"" +
+                                  line + "\"");
+    };
+
+    auto intern = [&](std::string_view name, const std::string& line) {
+        if (name.empty()) throw malformed(line);
+        auto [it, inserted] = id.try_emplace(std::string(name), static_cast<uint32_t>(names.size()));
+        if (inserted) names.push_back(&it->first);
+        return it->second;
+    };
+
+    auto problem = [&report, max_problems](const std::string& text) {
+        if (report.problems.size() < max_problems) report.problems.push_back(text);
+    };
+
+    auto add = [&](uint32_t from, uint32_t to, size_t weight) {
+        if (from == to) {
+            report.self_loops++;
+            problem("line " + std::to_string(report.lines) + ": self-loop at " + *names[from] + " is dropped");
+            return;
+        }
+        arcs.push_back({from, to, weight, report.lines});
+    };
+
+    std::string line;
+    while (std::getline(stream, line)) {
+        report.lines++;
+        std::string_view text = Trim(line);
+        if (text.empty() || text.front() == '#') continue;
+
+        size_t weight;
+        size_t colon = text.find(':');
+
+        if (colon == std::string_view::npos) {
+            size_t first_comma = text.find(',');
+            size_t second_comma = first_comma == std::string_view::npos ? first_comma : text.find(',', first_comma + 1);
+            if (second_comma == std::string_view::npos || !ParseWeight(text.substr(second_comma + 1), weight)) {
+                throw malformed(line);
+            }
+
+            uint32_t from = intern(Trim(text.substr(0, first_comma)), line);
+            uint32_t to = intern(Trim(text.substr(first_comma + 1, second_comma - first_comma - 1)), line);
+            add(from, to, weight);
+            continue;
+        }
+
+        uint32_t from = intern(Trim(text.substr(0, colon)), line);
+        std::string_view rest = text.substr(colon + 1);
+
+        while (!rest.empty()) {
+            size_t comma = rest.find(',');
+            std::string_view item = Trim(rest.substr(0, comma));
+            rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+            if (item.empty()) continue;
+
+            size_t space = item.find_last_of(" \t");
+            if (space == std::string_view::npos || !ParseWeight(item.substr(space + 1), weight)) throw malformed(line);
+
+            add(from, intern(Trim(item.substr(0, space)), line), weight);
+        }
+    }
+
+    /* Grouping the listings of every edge: by its smaller id, its larger id, the direction, and the line. */
+    std::sort(arcs.begin(), arcs.end(), [](const listedArc& lhs, const listedArc& rhs) {
+        auto key = [](const listedArc& arc) {
+            return std::make_tuple(std::min(arc.from, arc.to), std::max(arc.from, arc.to), arc.from, arc.line);
+        };
+        return key(lhs) < key(rhs);
+    });
+
+    graph.clear();
+    weights.clear();
+    for (const auto* name : names) {
+        graph[*name];
+        weights[*name];
+    }
+
+    for (size_t first = 0, last; first < arcs.size(); first = last) {
+        uint32_t lhs = std::min(arcs[first].from, arcs[first].to);
+        uint32_t rhs = std::max(arcs[first].from, arcs[first].to);
+
+        size_t weight = arcs[first].weight;
+        const listedArc* forward = nullptr;
+        const listedArc* backward = nullptr;
+
+        for (last = first; last < arcs.size() && std::min(arcs[last].from, arcs[last].to) == lhs &&
+                           std::max(arcs[last].from, arcs[last].to) == rhs; last++) {
+            const listedArc& arc = arcs[last];
+            const listedArc*& seen = arc.from == lhs ? forward : backward;
+
+            if (seen) {
+                report.duplicates++;
+                problem("line " + std::to_string(arc.line) + ": " + *names[arc.from] + " - " + *names[arc.to] +
+                        " is already listed on line " + std::to_string(seen->line));
+            } else {
+                seen = &arc;
+            }
+            weight = std::min(weight, arc.weight);
+        }
+
+        if (forward && backward && forward->weight != backward->weight) {
+            report.asymmetric++;
+            problem("line " + std::to_string(backward->line) + ": " + *names[rhs] + " - " + *names[lhs] + " weighs " +
+                    std::to_string(backward->weight) + ", but line " + std::to_string(forward->line) + " gives " +
+                    std::to_string(forward->weight) + "; keeping " + std::to_string(weight));
+        }
+
+        graph[*names[lhs]].push_back(*names[rhs]);
+        weights[*names[lhs]].push_back(weight);
+        graph[*names[rhs]].push_back(*names[lhs]);
+        weights[*names[rhs]].push_back(weight);
+        report.edges++;
+    }
+
+    version++;
+
+    return report;
+}
+
+/**
+ * It returns the neighbours of a country without inserting it into the graph, so lookups do not modify the solver.
+ *
+ * Args:
+ *   country (string): the country
+ *
+ * Returns:
+ *   The neighbours of the country, or an empty list if it has no entry.
+ */
+const std::vector<std::string>& graphSolver::Neighbours(const std::string& country) const {
+    static const std::vector<std::string> empty;
+
+    auto it = graph.find(country);
+    return it == graph.end() ? empty : it->second;
+}
+
+/**
+ * It computes a structural hash of the graph: the sorted list of its edges by country name. It does not depend on
+ * the order of the hash map or on `vertex_order`, so the same graph has the same fingerprint in every process.
+ *
+ * The hash is recomputed only when `version` changed.
+ *
+ * Returns:
+ *   The 64-bit fingerprint.
+ */
+uint64_t graphSolver::Fingerprint() {
+    if (fingerprint_version == version) return fingerprint;
+
+    std::map<std::string, std::set<std::string>> edges;
+    for (const auto& [from, to] : graph) {
+        auto& neighbours = edges[from];
+        neighbours.insert(to.begin(), to.end());
+    }
+
+    fingerprint = HashBytes("graphSolver");
+    for (const auto& [from, to] : edges) {
+        fingerprint = HashBytes(from + '\n', fingerprint);
+        for (const auto& country : to) {
+            fingerprint = HashBytes(country + '\t', fingerprint);
+        }
+    }
+
+    /* The weights are hashed after the edges, so unweighted graphs keep their fingerprints. */
+    if (!weights.empty()) {
+        std::map<std::pair<std::string, std::string>, size_t> weighted;
+        for (const auto& [from, row] : weights) {
+            const auto& to = Neighbours(from);
+            for (size_t i = 0; i < row.size() && i < to.size(); i++) {
+                auto [it, inserted] = weighted.try_emplace({from, to[i]}, row[i]);
+                if (!inserted) it->second = std::min(it->second, row[i]);
+            }
+        }
+
+        fingerprint = HashBytes("weights", fingerprint);
+        for (const auto& [edge, weight] : weighted) {
+            fingerprint = HashBytes(edge.first + '\t' + edge.second + '\t' + std::to_string(weight) + '\n', fingerprint);
+        }
+    }
+
+    fingerprint_version = version;
+    return fingerprint;
+}
+
+bool graphSolver::CacheGet(const std::string& query, std::string& result) {
+    return use_cache && cache.Get(Fingerprint(), query, result);
+}
+
+void graphSolver::CachePut(const std::string& query, const std::string& result) {
+    if (use_cache) cache.Put(Fingerprint(), query, result);
+}
+
+/**
+ * It assigns every country a dense id (in the order chosen by `vertex_order`, lexicographic by default) and builds the
+ * id-based adjacency lists, which are sorted and free of duplicates and self-loops.
+ *
+ * Countries that only occur as neighbours also get an id, so every id in `adjacency` can be resolved with `name_of`.
+ */
+void graphSolver::IndexVertices() {
+    if (indexed_version == version && indexed_order == vertex_order) return;
+    indexed_version = version;
+    indexed_order = vertex_order;
+
+    std::set<std::string> countries;
+    for (const auto& [from, to] : graph) {
+        countries.insert(from);
+        countries.insert(to.begin(), to.end());
+    }
+
+    index_of.clear();
+    name_of.assign(countries.begin(), countries.end());
+    for (size_t id = 0; id < name_of.size(); id++) {
+        index_of[name_of[id]] = id;
+    }
+
+    adjacency.assign(name_of.size(), {});
+    for (const auto& [from, to] : graph) {
+        size_t from_id = index_of[from];
+        for (const auto& to_country : to) {
+            size_t to_id = index_of[to_country];
+            if (to_id == from_id) continue;
+            adjacency[from_id].push_back(to_id);
+            adjacency[to_id].push_back(from_id);
+        }
+    }
+
+    for (auto& neighbours : adjacency) {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    if (vertex_order == vertexOrder::lexicographic) return;
+
+    /* Renumbering the vertices, order[new_id] is the old id. */
+    std::vector<size_t> order = ComputeVertexOrder(adjacency.size(), [this](size_t v) -> const std::vector<size_t>& {
+        return adjacency[v];
+    }, vertex_order);
+
+    std::vector<size_t> new_id(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        new_id[order[i]] = i;
+    }
+
+    std::vector<std::string> names(order.size());
+    std::vector<std::vector<size_t>> renumbered(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        names[i] = std::move(name_of[order[i]]);
+        index_of[names[i]] = i;
+
+        for (size_t to : adjacency[order[i]]) {
+            renumbered[i].push_back(new_id[to]);
+        }
+        std::sort(renumbered[i].begin(), renumbered[i].end());
+    }
+
+    name_of = std::move(names);
+    adjacency = std::move(renumbered);
+}
+
+/**
+ * It renumbers the vertices in the given order, which is kept for every later IndexVertices call. Results are still
+ * reported by country name, only the ids (and the memory layout of the traversals) change.
+ *
+ * Args:
+ *   order (vertexOrder): the new vertex order
+ */
+void graphSolver::Reorder(vertexOrder order) {
+    vertex_order = order;
+    IndexVertices();
+}
+
 /**
  * It finds the maximum distance from a given country to any other country
  *
@@ -53,27 +421,31 @@ std::istream& operator>>(std::istream& stream, graphSolver& g) {
  *   The eccentricity of the country.
  */
 size_t graphSolver::FindEccentricity(const std::string& country) {
-    std::unordered_map<std::string, size_t> dist;
-    std::queue<std::string> q;
-
-    q.push(country);
-    dist[country] = 0;
-
-    size_t eccentricity = 0;
-    while (!q.empty()) {
-        auto from_county = q.front();
-        q.pop();
-
-        for (const auto& to_country : graph[from_county]) {
-            if (!dist.count(to_country) || dist[to_country] > dist[from_county] + 1) {
-                dist[to_country] = dist[from_county] + 1;
-                eccentricity = std::max(eccentricity, dist[to_country]);
-                q.push(to_country);
-            }
-        }
-    }
+    PROFILE_ALLOCATIONS("graphSolver::FindEccentricity");
 
-    return eccentricity;
+    IndexVertices();
+
+    auto it = index_of.find(country);
+    if (it == index_of.end()) return 0;
+
+    return FindEccentricity(it->second);
+}
+
+/**
+ * It finds the eccentricity of the vertex with the given id by a BFS over the id adjacency lists built by
+ * IndexVertices, with the direction-optimizing kernel of traversal.h.
+ *
+ * Args:
+ *   id (size_t): The id of the country.
+ *
+ * Returns:
+ *   The eccentricity of the country.
+ */
+size_t graphSolver::FindEccentricity(size_t id) {
+    adjacencyListView view{adjacency};
+    bfsKernel<adjacencyListView> bfs(view, threads);
+    bfs.Run(id);
+    return bfs.Depth();
 }
 
 /**
@@ -83,16 +455,33 @@ size_t graphSolver::FindEccentricity(const std::string& country) {
  *   A pair of strings and size_t.
  */
 std::pair<std::string, size_t> graphSolver::FindRadius() {
+    PROFILE_ALLOCATIONS("graphSolver::FindRadius");
+
+    std::string cached;
+    if (CacheGet("FindRadius", cached)) {
+        auto lines = SplitLines(cached);
+        return {lines[0], std::stoull(lines[1])};
+    }
+
     std::pair<std::string, size_t> radius = {"", INT_MAX};
 
+    IndexVertices();
+
+    /* One kernel for all sources, so its arrays are allocated once. */
+    adjacencyListView view{adjacency};
+    bfsKernel<adjacencyListView> bfs(view, threads);
+
     for (auto [from, to]: graph) {
-        size_t eccentricity = FindEccentricity(from);
+        bfs.Run(index_of.at(from));
+        size_t eccentricity = bfs.Depth();
         if (eccentricity < radius.second) {
             radius.first = from;
             radius.second = eccentricity;
         }
     }
 
+    CachePut("FindRadius", JoinLines({radius.first, std::to_string(radius.second)}));
+
     return radius;
 }
 
@@ -104,16 +493,32 @@ std::pair<std::string, size_t> graphSolver::FindRadius() {
  *   A pair of strings and size_t.
  */
 std::pair<std::string, size_t> graphSolver::FindDiameter() {
+    PROFILE_ALLOCATIONS("graphSolver::FindDiameter");
+
+    std::string cached;
+    if (CacheGet("FindDiameter", cached)) {
+        auto lines = SplitLines(cached);
+        return {lines[0], std::stoull(lines[1])};
+    }
+
     std::pair<std::string, size_t> diameter = {"", 0};
 
+    IndexVertices();
+
+    adjacencyListView view{adjacency};
+    bfsKernel<adjacencyListView> bfs(view, threads);
+
     for (auto [from, to]: graph) {
-        size_t eccentricity = FindEccentricity(from);
+        bfs.Run(index_of.at(from));
+        size_t eccentricity = bfs.Depth();
         if (eccentricity > diameter.second) {
             diameter.first = from;
             diameter.second = eccentricity;
         }
     }
 
+    CachePut("FindDiameter", JoinLines({diameter.first, std::to_string(diameter.second)}));
+
     return diameter;
 }
 
@@ -125,15 +530,28 @@ std::pair<std::string, size_t> graphSolver::FindDiameter() {
  *   A vector of strings.
  */
 std::vector<std::string> graphSolver::FindCenter() {
+    PROFILE_ALLOCATIONS("graphSolver::FindCenter");
+
+    std::string cached;
+    if (CacheGet("FindCenter", cached)) return SplitLines(cached);
+
     size_t radius = FindRadius().second;
     std::vector<std::string> center;
 
+    /* FindRadius may come from the cache, which skips the indexing. */
+    IndexVertices();
+    adjacencyListView view{adjacency};
+    bfsKernel<adjacencyListView> bfs(view, threads);
+
     for (const auto& [from, to] : graph) {
-        if (FindEccentricity(from) == radius) {
+        bfs.Run(index_of.at(from));
+        if (bfs.Depth() == radius) {
             center.emplace_back(from);
         }
     }
 
+    CachePut("FindCenter", JoinLines(center));
+
     return center;
 }
 
@@ -173,8 +591,8 @@ void graphSolver::Bronkerbosch(std::set<std::string> R, std::set<std::string> P,
 // neighbors of v
     for (const auto& v : P) {
         Bronkerbosch(SetUnion(R, {v}),
-                     SetIntersection(PP, VectorToSet(graph[v])),
-                     SetIntersection(X, VectorToSet(graph[v])),
+                     SetIntersection(PP, VectorToSet(Neighbours(v))),
+                     SetIntersection(X, VectorToSet(Neighbours(v))),
                      max_clique);
 
         PP = SetDiffence(PP, {v});
@@ -184,28 +602,174 @@ void graphSolver::Bronkerbosch(std::set<std::string> R, std::set<std::string> P,
 
 /**
 
-This function calls the Bron-Kerbosch algorithm to find the maximum clique in the graph.
+This function calls the Bron-Kerbosch algorithm to find the maximum clique in the graph. Graphs with at most
+dense_graph_limit vertices are solved on bitset adjacency matrices instead (see denseGraph.h).
 
 @return The set of nodes that form the maximum clique, represented as a set of vertex labels
 */
 std::set<std::string> graphSolver::Bronkerbosch() {
+    PROFILE_ALLOCATIONS("graphSolver::Bronkerbosch");
 
-// Initialize the set of candidates to be all vertices in the graph
-    std::set<std::string> candidates;
-    for (auto [from, to] : graph) {
-        candidates.insert(from);
+    std::string cached;
+    if (CacheGet("Bronkerbosch", cached)) {
+        auto lines = SplitLines(cached);
+        return {lines.begin(), lines.end()};
     }
 
     std::set<std::string> max_clique;
 
+    /* Small graphs are solved on bitset adjacency matrices. */
+    IndexVertices();
+    if (adjacency.size() <= dense_graph_limit) {
+        auto ids = WithDenseGraph(adjacency, [](const auto& dense) { return dense.MaximumClique(); });
+        for (size_t id : ids) max_clique.insert(name_of[id]);
+    } else {
+// Initialize the set of candidates to be all vertices in the graph
+        std::set<std::string> candidates;
+        for (auto [from, to] : graph) {
+            candidates.insert(from);
+        }
+
 // Call the Bron-Kerbosch algorithm with an empty clique, the set of candidates, an empty set of visited vertices,
 // and a reference to the variable holding the maximum clique
-    Bronkerbosch({}, candidates, {}, max_clique);
+        Bronkerbosch({}, candidates, {}, max_clique);
+    }
+
+    CachePut("Bronkerbosch", JoinLines({max_clique.begin(), max_clique.end()}));
 
 // Return the maximum clique
     return max_clique;
 }
 
+/**
+ * It searches for a maximum clique within a time, node or cancellation budget.
+ *
+ * Args:
+ *   budget (searchBudget): the limits of the search and the optional progress callback
+ *
+ * Returns:
+ *   The largest clique found and a proven upper bound on the size of the maximum clique. If the search finished,
+ *   the two are equal and `optimal` is set.
+ */
+searchResult<std::set<std::string>> graphSolver::Bronkerbosch(const searchBudget& budget) {
+    PROFILE_ALLOCATIONS("graphSolver::Bronkerbosch(budget)");
+
+    IndexVertices();
+
+    auto ids = MaximumCliqueSearch(adjacency, budget);
+
+    searchResult<std::set<std::string>> result;
+    for (size_t id : ids.best) result.best.insert(name_of[id]);
+    result.upper_bound = ids.upper_bound;
+    result.nodes = ids.nodes;
+    result.optimal = ids.optimal;
+    return result;
+}
+
+/**
+ * Recursive step of the maximal clique enumeration (Bron-Kerbosch with Tomita pivoting over sorted id vectors).
+ *
+ * Args:
+ *   R (vector<size_t>): the current clique, extended and restored in place
+ *   P (vector<size_t>): sorted candidates that are adjacent to every vertex of R
+ *   X (vector<size_t>): sorted vertices adjacent to every vertex of R whose cliques were already reported
+ *   callback (cliqueCallback): receives every maximal clique, returns false to stop the enumeration
+ *   min_size (size_t): cliques smaller than this are neither reported nor explored
+ *   stop (bool): set once the callback asked to stop
+ */
+void graphSolver::EnumerateMaximalCliques(std::vector<size_t>& R, std::vector<size_t> P, std::vector<size_t> X,
+                                          const cliqueCallback& callback, size_t min_size, bool& stop) {
+    if (P.empty()) {
+        if (X.empty() && R.size() >= min_size) {
+            stop = !callback(R);
+        }
+        return;
+    }
+
+    /* Even taking every candidate cannot reach the requested size. */
+    if (R.size() + P.size() < min_size) return;
+
+    /* Choosing the pivot with the most neighbours among the candidates, so that the fewest branches are explored. */
+    size_t pivot = P.front();
+    size_t best_cover = 0;
+    std::vector<size_t> buffer;
+    for (const auto* side : {&P, &X}) {
+        for (size_t u : *side) {
+            buffer.clear();
+            std::set_intersection(P.begin(), P.end(), adjacency[u].begin(), adjacency[u].end(),
+                                  std::back_inserter(buffer));
+            if (buffer.size() >= best_cover) {
+                best_cover = buffer.size();
+                pivot = u;
+            }
+        }
+    }
+
+    std::vector<size_t> branches;
+    std::set_difference(P.begin(), P.end(), adjacency[pivot].begin(), adjacency[pivot].end(),
+                        std::back_inserter(branches));
+
+    for (size_t v : branches) {
+        std::vector<size_t> next_P;
+        std::vector<size_t> next_X;
+        std::set_intersection(P.begin(), P.end(), adjacency[v].begin(), adjacency[v].end(),
+                              std::back_inserter(next_P));
+        std::set_intersection(X.begin(), X.end(), adjacency[v].begin(), adjacency[v].end(),
+                              std::back_inserter(next_X));
+
+        R.push_back(v);
+        EnumerateMaximalCliques(R, std::move(next_P), std::move(next_X), callback, min_size, stop);
+        R.pop_back();
+
+        if (stop) return;
+
+        /* Moving v from the candidates to the excluded vertices, keeping both vectors sorted. */
+        P.erase(std::lower_bound(P.begin(), P.end(), v));
+        X.insert(std::lower_bound(X.begin(), X.end(), v), v);
+    }
+}
+
+/**
+ * It reports every maximal clique of the graph exactly once, without collecting them.
+ *
+ * The vertices are processed in degeneracy order, so each top-level call only looks at the later neighbours of one
+ * vertex. Memory use is bounded by the recursion depth times the maximum degree.
+ *
+ * Args:
+ *   callback (cliqueCallback): called with the ids of the clique (resolve them with `name_of`); the vector is only
+ *     valid during the call. Returning false stops the enumeration.
+ *   min_size (size_t): only cliques with at least this many vertices are reported
+ */
+void graphSolver::EnumerateMaximalCliques(const cliqueCallback& callback, size_t min_size) {
+    PROFILE_ALLOCATIONS("graphSolver::EnumerateMaximalCliques");
+
+    IndexVertices();
+
+    size_t n = adjacency.size();
+
+    std::vector<size_t> order = DegeneracyOrder(adjacency);
+    std::vector<size_t> position(n);
+    for (size_t i = 0; i < n; i++) {
+        position[order[i]] = i;
+    }
+
+    bool stop = false;
+    std::vector<size_t> R;
+    for (size_t v : order) {
+        std::vector<size_t> P;
+        std::vector<size_t> X;
+        for (size_t to : adjacency[v]) {
+            (position[to] > position[v] ? P : X).push_back(to);
+        }
+
+        R.push_back(v);
+        EnumerateMaximalCliques(R, std::move(P), std::move(X), callback, min_size, stop);
+        R.pop_back();
+
+        if (stop) return;
+    }
+}
+
 /**
  * For each country in the candidates set, we remove it from the candidates set, add it to the stable set, and then
  * recursively call the function with the new stable set and the new candidates set
@@ -232,7 +796,7 @@ void graphSolver::FindMaximumStableSet(std::set<std::string> stable_set,
         /* It's adding the country to the stable set, and then removing all the countries that are connected to the
         country from the candidates set. */
         FindMaximumStableSet(SetUnion(stable_set, {country}),
-                             SetDiffence(candidates, VectorToSet(graph[country])),
+                             SetDiffence(candidates, VectorToSet(Neighbours(country))),
                              max_stable_set);
     }
 
@@ -240,12 +804,45 @@ void graphSolver::FindMaximumStableSet(std::set<std::string> stable_set,
 
 /**
  * We start with an empty set of vertices, and a set of all vertices. We then recursively call the function with the
- * current set of vertices, and the set of all vertices minus the current set of vertices
+ * current set of vertices, and the set of all vertices minus the current set of vertices.
+ *
+ * Graphs of small treewidth are solved first by dynamic programming over a min-fill tree decomposition, if its width
+ * is at most decomposition_width_limit. Bipartite graphs are solved next, as the complement of the Konig vertex cover.
+ * Other graphs with at most dense_graph_limit vertices are solved as a maximum clique of the complement, on bitsets.
  *
  * Returns:
  *   A set of strings.
  */
 std::set<std::string> graphSolver::FindMaximumStableSet() {
+    PROFILE_ALLOCATIONS("graphSolver::FindMaximumStableSet");
+
+    IndexVertices();
+
+    auto decomposition = EliminationDecomposition(adjacency, eliminationHeuristic::min_fill,
+                                                  decomposition_width_limit);
+    if (decomposition.Complete()) {
+        std::set<std::string> max_stable_set;
+        for (size_t id : StableSetByDecomposition(adjacency, decomposition)) max_stable_set.insert(name_of[id]);
+        return max_stable_set;
+    }
+
+    matching max_matching;
+    std::set<std::string> minimum_vertex_cover;
+    if (FindBipartiteMatching(max_matching, minimum_vertex_cover)) {
+        std::set<std::string> max_stable_set;
+        for (const auto& country : name_of) {
+            if (!minimum_vertex_cover.count(country)) max_stable_set.insert(country);
+        }
+        return max_stable_set;
+    }
+
+    if (adjacency.size() <= dense_graph_limit) {
+        std::set<std::string> max_stable_set;
+        auto ids = WithDenseGraph(adjacency, [](const auto& dense) { return dense.MaximumStableSet(); });
+        for (size_t id : ids) max_stable_set.insert(name_of[id]);
+        return max_stable_set;
+    }
+
     std::set<std::string> candidates;
 
     /* It's iterating over the graph and adding each country to the candidates set. */
@@ -260,6 +857,30 @@ std::set<std::string> graphSolver::FindMaximumStableSet() {
     return max_stable_set;
 }
 
+/**
+ * It searches for a maximum stable set within a time, node or cancellation budget.
+ *
+ * Args:
+ *   budget (searchBudget): the limits of the search and the optional progress callback
+ *
+ * Returns:
+ *   The largest stable set found and a proven upper bound on the size of the maximum stable set.
+ */
+searchResult<std::set<std::string>> graphSolver::FindMaximumStableSet(const searchBudget& budget) {
+    PROFILE_ALLOCATIONS("graphSolver::FindMaximumStableSet(budget)");
+
+    IndexVertices();
+
+    auto ids = MaximumStableSetSearch(adjacency, budget);
+
+    searchResult<std::set<std::string>> result;
+    for (size_t id : ids.best) result.best.insert(name_of[id]);
+    result.upper_bound = ids.upper_bound;
+    result.nodes = ids.nodes;
+    result.optimal = ids.optimal;
+    return result;
+}
+
 /**
  * It takes a set of candidates, and for each candidate, it checks if there's a candidate in the other set that is
  * connected to it. If there is, it adds the pair to the current matching, and recursively calls itself with the new set of
@@ -281,11 +902,12 @@ void graphSolver::FindMaximumMatching(matching current,
 
     auto tmp_candidates = candidates;
 
-    if (max_matching.size() == 19) return; //you can comment it out to do an exhaustive search, but for the task i did, 19 was found to be the maximum
+    /* No matching can be larger than one that pairs up every candidate. */
+    if (max_matching.size() >= current.size() + candidates.size() / 2) return;
 
     /* Finding the maximum matching in a bipartite graph. */
     for (const auto& country : tmp_candidates) {
-        for (const auto& to_country : graph[country]) {
+        for (const auto& to_country : Neighbours(country)) {
             if (candidates.count(to_country)) {
                 if (!flag) current.emplace_back();
                 flag = true;
@@ -298,35 +920,332 @@ void graphSolver::FindMaximumMatching(matching current,
 
         candidates.erase(country);
     }
-    /* Checking if the current matching is larger than the max matching. If it is, it prints the current matching and sets
-    the max matching to the current matching. */
+    /* Checking if the current matching is larger than the max matching. If it is, it becomes the max matching. */
     if (!flag && current.size() > max_matching.size()) {
+        max_matching = current;
+    }
+}
 
-        std::cout << "Founded matching of size " << current.size() << '\n';
+/**
+ * It tries to 2-color the graph with a BFS from every uncolored vertex. Works on the ids from IndexVertices.
+ *
+ * Args:
+ *   side (vector<int>): receives the color (0 or 1) of every vertex id
+ *
+ * Returns:
+ *   True if the graph is bipartite, false if some edge joins two vertices of the same color.
+ */
+bool graphSolver::FindBipartition(std::vector<int>& side) {
+    side.assign(adjacency.size(), -1);
+    std::vector<size_t> queue;
+
+    for (size_t start = 0; start < adjacency.size(); start++) {
+        if (side[start] != -1) continue;
+
+        side[start] = 0;
+        queue.assign(1, start);
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            size_t from = queue[head];
+            for (size_t to : adjacency[from]) {
+                if (side[to] == -1) {
+                    side[to] = 1 - side[from];
+                    queue.push_back(to);
+                } else if (side[to] == side[from]) {
+                    return false;
+                }
+            }
+        }
+    }
 
-        for (auto [from, to] : current) {
-            std::cout << from << " " << to << '\n';
+    return true;
+}
+
+/**
+ * If the graph is bipartite, it finds a maximum matching with the Hopcroft-Karp algorithm in O(E * sqrt(V)) and
+ * derives a minimum vertex cover from it with Konig's theorem.
+ *
+ * Args:
+ *   max_matching (matching): receives the matching, every pair is (vertex of color 0, vertex of color 1)
+ *   minimum_vertex_cover (set<std::string>): receives the vertex cover, which has the same size as the matching
+ *
+ * Returns:
+ *   False (leaving both arguments untouched) if the graph is not bipartite.
+ */
+bool graphSolver::FindBipartiteMatching(matching& max_matching, std::set<std::string>& minimum_vertex_cover) {
+    IndexVertices();
+
+    std::vector<int> side;
+    if (!FindBipartition(side)) return false;
+
+    const size_t none = SIZE_MAX;
+    size_t n = adjacency.size();
+
+    std::vector<size_t> mate(n, none);
+    std::vector<size_t> dist(n);
+    std::vector<size_t> next(n);
+    std::vector<size_t> queue;
+    std::vector<size_t> stack;
+
+    while (true) {
+        /* BFS from the free left vertices, layering the left vertices by the length of their alternating paths. */
+        queue.clear();
+        for (size_t u = 0; u < n; u++) {
+            dist[u] = none;
+            if (side[u] == 0 && mate[u] == none) {
+                dist[u] = 0;
+                queue.push_back(u);
+            }
         }
 
-        std::cout << "\n---------------------\n";
+        bool found_free = false;
+        for (size_t head = 0; head < queue.size(); head++) {
+            size_t u = queue[head];
+            for (size_t v : adjacency[u]) {
+                size_t w = mate[v];
+                if (w == none) {
+                    found_free = true;
+                } else if (dist[w] == none) {
+                    dist[w] = dist[u] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
 
-        max_matching = current;
+        if (!found_free) break;
+
+        /* DFS along the layers from every free left vertex, augmenting a maximal set of disjoint shortest paths. */
+        std::fill(next.begin(), next.end(), 0);
+        for (size_t start = 0; start < n; start++) {
+            if (side[start] != 0 || mate[start] != none) continue;
+
+            stack.assign(1, start);
+            while (!stack.empty()) {
+                size_t u = stack.back();
+                if (next[u] == adjacency[u].size()) {
+                    dist[u] = none;
+                    stack.pop_back();
+                    continue;
+                }
+
+                size_t v = adjacency[u][next[u]++];
+                size_t w = mate[v];
+
+                if (w == none) {
+                    /* The stack is an alternating path ending in the free vertex v, flipping it along the way. */
+                    for (size_t x : stack) {
+                        size_t y = adjacency[x][next[x] - 1];
+                        mate[x] = y;
+                        mate[y] = x;
+                    }
+                    break;
+                }
+
+                if (dist[w] == dist[u] + 1) stack.push_back(w);
+            }
+        }
+    }
+
+    /* Konig: Z is everything reachable from the free left vertices by alternating paths,
+    the cover is (left \ Z) + (right & Z). */
+    std::vector<bool> reached(n, false);
+    queue.clear();
+    for (size_t u = 0; u < n; u++) {
+        if (side[u] == 0 && mate[u] == none) {
+            reached[u] = true;
+            queue.push_back(u);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        size_t u = queue[head];
+        for (size_t v : adjacency[u]) {
+            if (reached[v] || mate[u] == v) continue;
+            reached[v] = true;
+            if (mate[v] != none && !reached[mate[v]]) {
+                reached[mate[v]] = true;
+                queue.push_back(mate[v]);
+            }
+        }
+    }
+
+    max_matching.clear();
+    minimum_vertex_cover.clear();
+    for (size_t u = 0; u < n; u++) {
+        if (side[u] == 0 && mate[u] != none) max_matching.emplace_back(name_of[u], name_of[mate[u]]);
+        if ((side[u] == 0) != reached[u]) minimum_vertex_cover.insert(name_of[u]);
     }
+
+    return true;
 }
 
 matching graphSolver::FindMaximumMatching() {
-    /* Finding the maximum matching in a bipartite graph. */
-    std::set<std::string> candidates;
+    PROFILE_ALLOCATIONS("graphSolver::FindMaximumMatching");
 
-    for (auto [from, to] : graph) {
+    /* Bipartite graphs are solved exactly in polynomial time. */
+    matching max_matching;
+    std::set<std::string> vertex_cover;
+
+    if (FindBipartiteMatching(max_matching, vertex_cover)) return max_matching;
+
+    /* General graphs are searched by branch and bound with an unlimited budget, so the result is exact. */
+    return FindMaximumMatching(searchBudget{}).best;
+}
+
+/**
+ * It searches for a maximum matching within a time, node or cancellation budget. Bipartite graphs are solved exactly
+ * by Hopcroft-Karp without using the budget.
+ *
+ * Args:
+ *   budget (searchBudget): the limits of the search and the optional progress callback
+ *
+ * Returns:
+ *   The largest matching found and a proven upper bound on the size of the maximum matching.
+ */
+searchResult<matching> graphSolver::FindMaximumMatching(const searchBudget& budget) {
+    PROFILE_ALLOCATIONS("graphSolver::FindMaximumMatching(budget)");
+
+    searchResult<matching> result;
+    std::set<std::string> vertex_cover;
+
+    if (FindBipartiteMatching(result.best, vertex_cover)) {
+        result.upper_bound = result.best.size();
+        result.optimal = true;
+        return result;
+    }
+
+    auto ids = MaximumMatchingSearch(adjacency, budget);
+
+    for (auto [from, to] : ids.best) result.best.emplace_back(name_of[from], name_of[to]);
+    result.upper_bound = ids.upper_bound;
+    result.nodes = ids.nodes;
+    result.optimal = ids.optimal;
+    return result;
+}
+
+/**
+ * It searches for the smallest vertex cover by branching on an edge whose endpoints are both undecided: either its
+ * first endpoint is in the cover, or all of that endpoint's undecided neighbours are.
+ *
+ * Args:
+ *   current_vertex_cover (set<std::string>): the vertices put into the cover so far
+ *   candidates (set<std::string>): the undecided vertices; every edge with an endpoint outside both sets is covered
+ *   minimum_vertex_cover (set<std::string>): the smallest cover found so far
+ */
+void graphSolver::FindMinimumVertexCover(std::set<std::string> current_vertex_cover,
+                                         std::set<std::string> candidates,
+                                         std::set<std::string>& minimum_vertex_cover) {
+    /* This branch cannot beat the cover we already have. */
+    if (!minimum_vertex_cover.empty() && current_vertex_cover.size() >= minimum_vertex_cover.size()) return;
+
+    for (const auto& country : candidates) {
+        std::set<std::string> uncovered = SetIntersection(candidates, VectorToSet(Neighbours(country)));
+        uncovered.erase(country);
+        if (uncovered.empty()) continue;
+
+        /* Either the country itself covers its edges... */
+        FindMinimumVertexCover(SetUnion(current_vertex_cover, {country}),
+                               SetDiffence(candidates, {country}),
+                               minimum_vertex_cover);
+
+        /* ...or it stays outside and all its undecided neighbours must be in the cover. */
+        FindMinimumVertexCover(SetUnion(current_vertex_cover, uncovered),
+                               SetDiffence(SetDiffence(candidates, uncovered), {country}),
+                               minimum_vertex_cover);
+        return;
+    }
+
+    /* No undecided edges are left, so the current set is a vertex cover. */
+    if (minimum_vertex_cover.empty() || current_vertex_cover.size() < minimum_vertex_cover.size()) {
+        minimum_vertex_cover = current_vertex_cover;
+    }
+}
+
+/**
+ * It finds a minimum vertex cover: by dynamic programming over a tree decomposition if the graph has one of width at
+ * most decomposition_width_limit, otherwise with Konig's theorem if the graph is bipartite, otherwise as the complement
+ * of a maximum stable set on bitsets for graphs with at most dense_graph_limit vertices, otherwise by branching. The
+ * polynomial methods come first, so the exponential bitset search only gets the graphs they cannot solve.
+ *
+ * Returns:
+ *   A set of strings.
+ */
+std::set<std::string> graphSolver::FindMinimumVertexCover() {
+    PROFILE_ALLOCATIONS("graphSolver::FindMinimumVertexCover");
+
+    matching max_matching;
+    std::set<std::string> minimum_vertex_cover;
+
+    IndexVertices();
+
+    auto decomposition = EliminationDecomposition(adjacency, eliminationHeuristic::min_fill,
+                                                  decomposition_width_limit);
+    if (decomposition.Complete()) {
+        for (size_t id : VertexCoverByDecomposition(adjacency, decomposition)) {
+            minimum_vertex_cover.insert(name_of[id]);
+        }
+        return minimum_vertex_cover;
+    }
+
+    if (FindBipartiteMatching(max_matching, minimum_vertex_cover)) return minimum_vertex_cover;
+
+    if (adjacency.size() <= dense_graph_limit) {
+        auto ids = WithDenseGraph(adjacency, [](const auto& dense) { return dense.MinimumVertexCover(); });
+        for (size_t id : ids) minimum_vertex_cover.insert(name_of[id]);
+        return minimum_vertex_cover;
+    }
+
+    std::set<std::string> candidates;
+    for (const auto& [from, to] : graph) {
         candidates.insert(from);
     }
 
+    FindMinimumVertexCover({}, candidates, minimum_vertex_cover);
+
+    return minimum_vertex_cover;
+}
+
+/**
+ * It searches for a minimum vertex cover within a time, node or cancellation budget. Graphs with a narrow tree
+ * decomposition and bipartite graphs are solved exactly without using the budget; for the others the cover is the
+ * complement of the stable set found by the budgeted search.
+ *
+ * Args:
+ *   budget (searchBudget): the limits of the search and the optional progress callback
+ *
+ * Returns:
+ *   The smallest cover found, proven minimum if `optimal` is set. A cover is a minimum, so `upper_bound` is just the
+ *   size of the cover found.
+ */
+searchResult<std::set<std::string>> graphSolver::FindMinimumVertexCover(const searchBudget& budget) {
+    PROFILE_ALLOCATIONS("graphSolver::FindMinimumVertexCover(budget)");
+
+    searchResult<std::set<std::string>> result;
     matching max_matching;
 
-    FindMaximumMatching({}, candidates, max_matching);
+    IndexVertices();
+
+    auto decomposition = EliminationDecomposition(adjacency, eliminationHeuristic::min_fill,
+                                                  decomposition_width_limit);
+    if (decomposition.Complete()) {
+        for (size_t id : VertexCoverByDecomposition(adjacency, decomposition)) result.best.insert(name_of[id]);
+        result.optimal = true;
+    } else if (FindBipartiteMatching(max_matching, result.best)) {
+        result.optimal = true;
+    } else {
+        auto ids = MaximumStableSetSearch(adjacency, budget);
+
+        std::vector<bool> stable(adjacency.size(), false);
+        for (size_t id : ids.best) stable[id] = true;
+        for (size_t id = 0; id < adjacency.size(); id++) {
+            if (!stable[id]) result.best.insert(name_of[id]);
+        }
+        result.nodes = ids.nodes;
+        result.optimal = ids.optimal;
+    }
 
-    return max_matching;
+    result.upper_bound = result.best.size();
+    return result;
 }
 
 /**
@@ -339,7 +1258,7 @@ matching graphSolver::FindMaximumMatching() {
  *   current (string): The current country that the user is in.
  */
 void graphSolver::FindEulerianPath(std::set<std::pair<std::string, std::string>>& used, std::vector<std::string>& path, std::string current) {
-    for (const auto& to : graph[current]) {
+    for (const auto& to : Neighbours(current)) {
         if (!used.count({current, to})) {
             used.insert({current, to});
             used.insert({to, current});
@@ -352,6 +1271,8 @@ void graphSolver::FindEulerianPath(std::set<std::pair<std::string, std::string>>
 };
 
 void graphSolver::FindEulerPath() {
+    PROFILE_ALLOCATIONS("graphSolver::FindEulerPath");
+
     std::vector<std::string> path;
     std::set<std::pair<std::string, std::string>> used;
 
@@ -366,6 +1287,59 @@ void graphSolver::FindEulerPath() {
     }
 }
 
+/**
+ * It finds the shortest closed walk that traverses every edge (the Chinese postman problem), so that graphs with
+ * odd-degree countries need no manual editing before walking them. The loaded weights are used if there are any,
+ * otherwise every edge counts as 1.
+ *
+ * Args:
+ *   start (string): the first country of the walk; by default the first country of the component with the most edges.
+ *     Only the component of the start is walked.
+ *
+ * Returns:
+ *   The walk and its length. Throws std::invalid_argument if the start is not in the graph.
+ */
+postmanWalk graphSolver::FindPostmanWalk(const std::string& start) {
+    return FindPostmanWalk(searchBudget{}, start);
+}
+
+/**
+ * It finds a postman walk like FindPostmanWalk(start), but pairs the odd countries exactly only while the budget
+ * lasts. If it runs out, the pairing is finished greedily and `optimal` is false.
+ *
+ * Args:
+ *   budget (searchBudget): the limits of the exact pairing
+ *   start (string): the first country of the walk, as for FindPostmanWalk(start)
+ *
+ * Returns:
+ *   The walk and its length. Throws std::invalid_argument if the start is not in the graph.
+ */
+postmanWalk graphSolver::FindPostmanWalk(const searchBudget& budget, const std::string& start) {
+    PROFILE_ALLOCATIONS("graphSolver::FindPostmanWalk");
+
+    compactGraph g = Compact();
+    if (g.size() == 0) return {};
+
+    uint32_t source = 0;
+    if (!start.empty()) {
+        source = g.IdOf(start);
+        if (source == compactGraph::npos) {
+            throw std::invalid_argument("graphSolver: there is no country \"" + start + "\"");
+        }
+    } else {
+        auto component = ConnectedComponents(g);
+        std::vector<size_t> arcs(g.size(), 0);
+        for (uint32_t v = 0; v < g.size(); v++) {
+            arcs[component[v]] += g.Neighbours(v).size();
+        }
+
+        size_t largest = std::max_element(arcs.begin(), arcs.end()) - arcs.begin();
+        while (component[source] != largest) source++;
+    }
+
+    return PostmanWalk(g, source, postman_exact_limit, budget);
+}
+
 /**
  * It finds the minimum spanning tree of the graph
  *
@@ -449,11 +1423,27 @@ void graphSolver::FindMinimumSpanningTree(std::map<std::pair<std::string, std::s
  *   A spanning tree of the graph, represented as a vector of pairs. Each pair consists of a pair of connected countries
  *   and the distance between them.
  */
-spanningTree graphSolver::FindMinimumSpanningTree(std::map<std::string, std::vector<std::pair<std::string, int>>> distances) {
+spanningTree graphSolver::FindMinimumSpanningTree(const std::map<std::string, std::vector<std::pair<std::string, int>>>& distances) {
+    PROFILE_ALLOCATIONS("graphSolver::FindMinimumSpanningTree(distances)");
+
+    /* The weights are part of the query, so the cache key contains their hash. */
+    uint64_t weights_hash = HashBytes("distances");
+    for (const auto& [from, to] : distances) {
+        for (const auto& [country, cost] : to) {
+            weights_hash = HashBytes(from + '\t' + country + '\t' + std::to_string(cost) + '\n', weights_hash);
+        }
+    }
+
+    std::ostringstream query;
+    query << "FindMinimumSpanningTree " << std::hex << weights_hash;
+
+    std::string cached;
+    if (CacheGet(query.str(), cached)) return DeserializeTree(cached);
+
     // Convert the distances map to a map of pairs of countries and their distances
     std::map<std::pair<std::string, std::string>, size_t> dist;
-    for (auto [from, to] : distances) {
-        for (auto [country, cost] : to) {
+    for (const auto& [from, to] : distances) {
+        for (const auto& [country, cost] : to) {
             dist[{from, country}] = cost;
         }
     }
@@ -481,10 +1471,79 @@ spanningTree graphSolver::FindMinimumSpanningTree(std::map<std::string, std::vec
         }
     }
 
+    CachePut(query.str(), SerializeTree(minimum_spanning_tree));
+
     // Return the minimum spanning tree
     return minimum_spanning_tree;
 }
 
+/**
+ * It finds a minimum spanning forest with the weights loaded by LoadWeighted, using Kruskal's algorithm over the
+ * vertex ids. Edges without a weight count as 1.
+ *
+ * Returns:
+ *   The edges of the forest, one spanning tree for every connected component, in the order they were chosen.
+ */
+spanningTree graphSolver::FindMinimumSpanningTree() {
+    PROFILE_ALLOCATIONS("graphSolver::FindMinimumSpanningTree");
+
+    std::string cached;
+    if (CacheGet("FindMinimumSpanningTree weights", cached)) return DeserializeTree(cached);
+
+    IndexVertices();
+
+    struct weightedEdge {
+        size_t weight;
+        size_t from;
+        size_t to;
+    };
+
+    std::vector<weightedEdge> edges;
+    for (const auto& [from, to] : graph) {
+        auto row = weights.find(from);
+        size_t from_id = index_of.at(from);
+
+        for (size_t i = 0; i < to.size(); i++) {
+            size_t to_id = index_of.at(to[i]);
+            if (from_id == to_id) continue;
+
+            size_t weight = row != weights.end() && i < row->second.size() ? row->second[i] : 1;
+            edges.push_back({weight, std::min(from_id, to_id), std::max(from_id, to_id)});
+        }
+    }
+
+    /* Ties are broken by the ids, so the tree does not depend on the order of the hash map. */
+    std::sort(edges.begin(), edges.end(), [](const weightedEdge& lhs, const weightedEdge& rhs) {
+        return std::tie(lhs.weight, lhs.from, lhs.to) < std::tie(rhs.weight, rhs.from, rhs.to);
+    });
+
+    std::vector<size_t> parent(name_of.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    auto find = [&parent](size_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    spanningTree forest;
+    for (const auto& edge : edges) {
+        size_t a = find(edge.from);
+        size_t b = find(edge.to);
+        if (a == b) continue;
+
+        parent[a] = b;
+        forest.push_back({{name_of[edge.from], name_of[edge.to]}, edge.weight});
+        if (forest.size() + 1 == name_of.size()) break;
+    }
+
+    CachePut("FindMinimumSpanningTree weights", SerializeTree(forest));
+
+    return forest;
+}
+
 /**
  * The function finds the centroid of the graph
  *
@@ -500,7 +1559,7 @@ void graphSolver::FindCentroid(const std::string& node,
                                const distance_& dist,
                                size_t& weight, std::string prev) {
     used.insert(node);
-    for (const auto& to : graph[node]) {
+    for (const auto& to : Neighbours(node)) {
         /* Checking if the current node is the previous node or if the distance between the current node and the next node
         is not in the distance map. If either of these are true, then the loop continues. */
         if (to == prev || !dist.count({node, to})) continue;
@@ -524,6 +1583,17 @@ void graphSolver::FindCentroid(const std::string& node,
  *   The centroid of the graph and the weight of the centroid.
  */
 std::pair<std::string, size_t> graphSolver::FindCentroid(spanningTree& T) {
+    PROFILE_ALLOCATIONS("graphSolver::FindCentroid");
+
+    std::ostringstream query;
+    query << "FindCentroid " << std::hex << HashBytes(SerializeTree(T));
+
+    std::string cached;
+    if (CacheGet(query.str(), cached)) {
+        auto lines = SplitLines(cached);
+        return {lines[0], std::stoull(lines[1])};
+    }
+
     size_t min_weight = INT_MAX;
     std::string centroid;
 
@@ -555,6 +1625,8 @@ std::pair<std::string, size_t> graphSolver::FindCentroid(spanningTree& T) {
         }
     }
 
+    CachePut(query.str(), JoinLines({centroid, std::to_string(min_weight)}));
+
     return {centroid, min_weight};
 }
 
@@ -568,6 +1640,14 @@ std::pair<std::string, size_t> graphSolver::FindCentroid(spanningTree& T) {
  * @return A string of the Prufer code.
  */
 std::string graphSolver::PruferCode(spanningTree& spanning_tree) {
+    PROFILE_ALLOCATIONS("graphSolver::PruferCode");
+
+    std::ostringstream query;
+    query << "PruferCode " << std::hex << HashBytes(SerializeTree(spanning_tree));
+
+    std::string cached;
+    if (CacheGet(query.str(), cached)) return cached;
+
     std::map<std::string, std::set<std::string>> adjacency;
 
     for (auto [connected, cost] : spanning_tree) {
@@ -593,6 +1673,7 @@ std::string graphSolver::PruferCode(spanningTree& spanning_tree) {
         }
     }
 
+    CachePut(query.str(), prufer_code);
 
     return prufer_code;
 }
@@ -619,6 +1700,49 @@ std::string graphSolver::PruferCode(spanningTree& spanning_tree) {
 void graphSolver::addEdge(const std::string& lhs, const std::string& rhs) {
     graph[lhs].push_back(rhs);
     graph[rhs].push_back(lhs);
+    version++;
+
+    /* In a weighted graph the new edge weighs 1, so the rows of `weights` stay aligned with `graph`. */
+    if (!weights.empty()) {
+        weights[lhs].resize(graph[lhs].size(), 1);
+        weights[rhs].resize(graph[rhs].size(), 1);
+    }
+}
+
+/**
+ * It adds an edge with a weight. Rows that had no weights so far get weight 1 for their existing edges.
+ *
+ * Args:
+ *   lhs (string): one end of the edge
+ *   rhs (string): the other end of the edge
+ *   weight (size_t): the weight of the edge
+ */
+void graphSolver::addEdge(const std::string& lhs, const std::string& rhs, size_t weight) {
+    weights[lhs].resize(graph[lhs].size(), 1);
+    weights[rhs].resize(graph[rhs].size(), 1);
+
+    addEdge(lhs, rhs);
+
+    weights[lhs].back() = weight;
+    weights[rhs].back() = weight;
+}
+
+/**
+ * It hands the adjacency lists and weights to `edit`, and bumps the version afterwards, so the id index, the
+ * fingerprint and the cached results are rebuilt from the edited graph.
+ *
+ * Args:
+ *   edit (function): changes the lists and weights in place; weight rows must stay aligned with their list rows
+ */
+void graphSolver::Edit(const std::function<void(adjacencyMap& graph, weightMap& weights)>& edit) {
+    edit(graph, weights);
+    version++;
+}
+
+void graphSolver::Clear() {
+    graph.clear();
+    weights.clear();
+    version++;
 }
 
 void print(std::vector<int> container){
@@ -1,26 +1,84 @@
 #ifndef GRAPHSOLVER_GRAPHSOLVER_H
 #define GRAPHSOLVER_GRAPHSOLVER_H
 
-#define matching std::vector<std::pair<std::string,std::string>>
-#define spanningTree std::vector<std::pair<std::pair<std::string, std::string>, size_t>>
-#define distance_ std::map<std::pair<std::string, std::string>, size_t>
-
 #include <string>
 #include <unordered_map>
 #include <map>
 #include <vector>
 #include <set>
 #include <fstream>
+#include <functional>
 #include "OperationWithSet.h"
+#include "allocationProfiler.h"
+#include "basicGraph.h"
+#include "denseGraph.h"
+#include "vertexOrder.h"
+#include "resultCache.h"
+#include "anytimeSearch.h"
+#include "routeInspection.h"
+#include "treeDecomposition.h"
+
+using matching = std::vector<std::pair<std::string, std::string>>;
+using spanningTree = std::vector<std::pair<std::pair<std::string, std::string>, size_t>>;
+using distance_ = std::map<std::pair<std::string, std::string>, size_t>;
+using weightedAdjacency = std::map<std::string, std::vector<std::pair<std::string, int>>>;
+using cliqueCallback = std::function<bool(const std::vector<size_t>&)>;
+using adjacencyMap = std::unordered_map<std::string, std::vector<std::string>>;
+using weightMap = std::unordered_map<std::string, std::vector<size_t>>;
+
+//What LoadWeighted found while reading a weighted graph. Every problem is also described in `problems`, with its line.
+struct loadReport {
+    size_t lines = 0;
+    size_t edges = 0;
+    size_t duplicates = 0;      //an edge listed more than once in the same direction
+    size_t asymmetric = 0;      //an edge listed in both directions with different weights
+    size_t self_loops = 0;
+    std::vector<std::string> problems;
+};
 
 //This is a class that is used to solve different graph problems.
 class graphSolver {
 public:
-    std::unordered_map<std::string, std::vector<std::string>> graph;
     std::unordered_map<std::string, size_t> index_of;
+    std::vector<std::string> name_of;
+    std::vector<std::vector<size_t>> adjacency;
+    vertexOrder vertex_order = vertexOrder::lexicographic;
+
+    resultCache cache;
+    //Off by default, so results never come from an earlier run unless the caller asks for it.
+    bool use_cache = false;
+
+    //The threads a large BFS level is split over, 0 for one per hardware thread.
+    size_t threads = 0;
+
+    //The adjacency lists as loaded; every change goes through the loaders, addEdge, Edit or Clear.
+    const adjacencyMap& AdjacencyLists() const { return graph; }
+
+    //weights[country][i] is the weight of the edge to AdjacencyLists()[country][i]; it is empty for unweighted graphs.
+    const weightMap& EdgeWeights() const { return weights; }
+
+    //Bumped by every change of the graph; the id index, the fingerprint and the cache compare against it.
+    size_t Version() const { return version; }
+
+    //Lets `edit` change the lists and weights in place, and then invalidates everything derived from them.
+    void Edit(const std::function<void(adjacencyMap& graph, weightMap& weights)>& edit);
+
+    void Clear();
+
+    loadReport LoadWeighted(std::istream& stream);
+
+    const std::vector<std::string>& Neighbours(const std::string& country) const;
+
+    uint64_t Fingerprint();
+
+    void IndexVertices();
+
+    void Reorder(vertexOrder order);
 
     size_t FindEccentricity(const std::string& country);
 
+    size_t FindEccentricity(size_t id);
+
     std::pair<std::string, size_t> FindRadius();
 
     std::pair<std::string, size_t> FindDiameter();
@@ -29,23 +87,40 @@ public:
 
     std::set<std::string> Bronkerbosch();
 
+    searchResult<std::set<std::string>> Bronkerbosch(const searchBudget& budget);
+
     void Bronkerbosch(std::set<std::string> R, std::set<std::string> P, std::set<std::string> X,
                       std::set<std::string>& max_clique);
 
+    void EnumerateMaximalCliques(const cliqueCallback& callback, size_t min_size = 1);
+
+    void EnumerateMaximalCliques(std::vector<size_t>& R, std::vector<size_t> P, std::vector<size_t> X,
+                                 const cliqueCallback& callback, size_t min_size, bool& stop);
+
     void FindMaximumStableSet(std::set<std::string> stable_set,
                               std::set<std::string> candidates,
                               std::set<std::string>& max_stable_set);
 
     std::set<std::string> FindMaximumStableSet();
 
+    searchResult<std::set<std::string>> FindMaximumStableSet(const searchBudget& budget);
+
     void FindMaximumMatching(matching current,
                              std::set<std::string> candidates,
                              matching& max_matcing);
 
     std::vector<std::pair<std::string,std::string>> FindMaximumMatching();
 
+    searchResult<matching> FindMaximumMatching(const searchBudget& budget);
+
+    bool FindBipartition(std::vector<int>& side);
+
+    bool FindBipartiteMatching(matching& max_matching, std::set<std::string>& minimum_vertex_cover);
+
     std::set<std::string> FindMinimumVertexCover();
 
+    searchResult<std::set<std::string>> FindMinimumVertexCover(const searchBudget& budget);
+
     void FindMinimumVertexCover(std::set<std::string> current_vertex_cover,
                                 std::set<std::string> candidates,
                                 std::set<std::string>& minimum_vertex_cover);
@@ -54,11 +129,17 @@ public:
 
     void FindEulerianPath(std::set<std::pair<std::string, std::string>>& used, std::vector<std::string>& path, std::string current);
 
+    postmanWalk FindPostmanWalk(const std::string& start = "");
+
+    postmanWalk FindPostmanWalk(const searchBudget& budget, const std::string& start = "");
+
     void FindMinimumSpanningTree(std::map<std::pair<std::string, std::string>, size_t>& dist,
                                  spanningTree& spanning_tree, std::string start_country);
 
     std::vector<std::pair<std::pair<std::string, std::string>, size_t>>
-    FindMinimumSpanningTree(std::map<std::string, std::vector<std::pair<std::string, int>>> distances);
+    FindMinimumSpanningTree(const std::map<std::string, std::vector<std::pair<std::string, int>>>& distances);
+
+    spanningTree FindMinimumSpanningTree();
 
     void FindCentroid(const std::string& node,
                       std::set<std::string>& used,
@@ -71,8 +152,93 @@ public:
     std::string PruferCode(spanningTree& spanning_tree);
 
     void addEdge(const std::string& lhs, const std::string& rhs);
+
+    void addEdge(const std::string& lhs, const std::string& rhs, size_t weight);
+
+    template <typename Graph = compactGraph>
+    Graph Compact(const weightedAdjacency* distances = nullptr);
+
+private:
+    adjacencyMap graph;
+    weightMap weights;
+    size_t version = 0;
+
+    size_t indexed_version = SIZE_MAX;
+    vertexOrder indexed_order = vertexOrder::lexicographic;
+    size_t fingerprint_version = SIZE_MAX;
+    uint64_t fingerprint = 0;
+
+    bool CacheGet(const std::string& query, std::string& result);
+
+    void CachePut(const std::string& query, const std::string& result);
+
+    friend std::istream& operator>>(std::istream&, graphSolver& g);
 };
 
+/**
+ * It copies the graph into a basicGraph with the given id width, weight type and directedness.
+ *
+ * Countries get ids in lexicographic order. For undirected graphs every listed neighbour becomes an edge; for directed
+ * graphs only the listed direction is kept.
+ *
+ * Args:
+ *   distances (weightedAdjacency): optional weights, looked up as distances[from][to]; edges without a weight get
+ *     weight 1. If it is null the weights loaded with LoadWeighted are used, and without those the graph is unweighted.
+ *
+ * Returns:
+ *   The compact graph.
+ */
+template <typename Graph>
+Graph graphSolver::Compact(const weightedAdjacency* distances) {
+    using Id = typename Graph::id_type;
+    using Weight = typename Graph::weight_type;
+
+    std::set<std::string> countries;
+    for (const auto& [from, to] : graph) {
+        countries.insert(from);
+        countries.insert(to.begin(), to.end());
+    }
+
+    std::vector<std::string> names(countries.begin(), countries.end());
+    if (names.size() >= Graph::npos) {
+        throw std::length_error("graphSolver::Compact: the graph has too many vertices for the id type");
+    }
+
+    std::unordered_map<std::string, Id> id;
+    for (size_t i = 0; i < names.size(); i++) {
+        id[names[i]] = static_cast<Id>(i);
+    }
+
+    std::vector<typename Graph::edge> edges;
+    for (const auto& [from, to] : graph) {
+        const std::vector<std::pair<std::string, int>>* costs = nullptr;
+        if (distances) {
+            auto it = distances->find(from);
+            if (it != distances->end()) costs = &it->second;
+        }
+
+        const std::vector<size_t>* row_weights = nullptr;
+        if (!distances) {
+            auto it = weights.find(from);
+            if (it != weights.end()) row_weights = &it->second;
+        }
+
+        for (size_t i = 0; i < to.size(); i++) {
+            Weight weight = 1;
+            if (costs) {
+                for (const auto& [country, cost] : *costs) {
+                    if (country == to[i]) weight = static_cast<Weight>(cost);
+                }
+            } else if (row_weights && i < row_weights->size()) {
+                weight = static_cast<Weight>((*row_weights)[i]);
+            }
+            edges.push_back({id[from], id[to[i]], weight});
+        }
+    }
+
+    return Graph::Build(std::move(names), edges, distances != nullptr || !weights.empty());
+}
+
 void print(std::vector<int> container);
 
 
@@ -0,0 +1,429 @@
+#include "mappedGraph.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char magic[8] = "GSCSR01";
+    const uint64_t weighted_flag = 1;
+    const size_t header_size = 4 * sizeof(uint64_t);
+
+    size_t PaddedTo8(size_t bytes) {
+        return (bytes + 7) / 8 * 8;
+    }
+
+    //The byte offsets of the sections of a file with n vertices and the given number of arcs.
+    struct layout {
+        size_t offsets;
+        size_t targets;
+        size_t weights;
+        size_t names;
+
+        layout(size_t n, size_t arcs, bool weighted) {
+            offsets = header_size;
+            targets = offsets + (n + 1) * sizeof(uint64_t);
+            weights = targets + PaddedTo8(arcs * sizeof(uint32_t));
+            names = weights + (weighted ? arcs * sizeof(uint64_t) : 0);
+        }
+    };
+
+    //Reads the next edge of an edge list, skipping empty lines. Returns false at the end of the stream.
+    bool ReadEdge(std::istream& stream, std::string& line, uint64_t& from, uint64_t& to, uint64_t& weight,
+                  bool& has_weight) {
+        while (std::getline(stream, line)) {
+            std::istringstream fields(line);
+            if (!(fields >> from)) continue;
+            if (!(fields >> to)) throw std::runtime_error("mappedGraph: malformed edge \"" + line + "\"");
+            has_weight = static_cast<bool>(fields >> weight);
+            return true;
+        }
+        return false;
+    }
+}
+
+/**
+ * It maps a graph file written by Write or BuildFromEdgeList into memory.
+ *
+ * The file is checked once after mapping: the sections must fit in the file, the offsets must be monotone and end at
+ * the arc count, every target must be a vertex, and there must be one name per vertex. A truncated or foreign file
+ * is rejected here instead of sending Name() or the algorithms past the end of the mapping.
+ *
+ * Args:
+ *   path (string): the graph file
+ */
+mappedGraph::mappedGraph(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("mappedGraph: cannot open " + path);
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < header_size) {
+        close(fd);
+        throw std::runtime_error("mappedGraph: " + path + " is not a graph file");
+    }
+
+    length = info.st_size;
+    data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        throw std::runtime_error("mappedGraph: cannot map " + path);
+    }
+
+    /* The algorithms scan the arrays front to back, so the kernel can read ahead aggressively. */
+    madvise(data, length, MADV_SEQUENTIAL);
+
+    const char* bytes = static_cast<const char*>(data);
+    const auto* header = reinterpret_cast<const uint64_t*>(bytes);
+    if (std::memcmp(bytes, magic, sizeof(magic)) != 0) {
+        munmap(data, length);
+        data = nullptr;
+        throw std::runtime_error("mappedGraph: " + path + " is not a graph file");
+    }
+
+    auto reject = [this, &path](const char* problem) {
+        munmap(data, length);
+        data = nullptr;
+        throw std::runtime_error("mappedGraph: " + path + " is " + problem);
+    };
+
+    vertices = header[1];
+    arcs = header[2];
+    bool weighted = header[3] & weighted_flag;
+
+    /* Bounding the counts by the file length first, so the section offsets below cannot overflow. */
+    if (vertices >= npos || vertices > length / sizeof(uint64_t) || arcs > length / sizeof(uint32_t)) {
+        reject("truncated");
+    }
+
+    layout sections(vertices, arcs, weighted);
+    if (sections.names + sizeof(uint64_t) > length) reject("truncated");
+
+    offsets = reinterpret_cast<const uint64_t*>(bytes + sections.offsets);
+    targets = reinterpret_cast<const uint32_t*>(bytes + sections.targets);
+    weights = weighted ? reinterpret_cast<const uint64_t*>(bytes + sections.weights) : nullptr;
+
+    uint64_t names_length = *reinterpret_cast<const uint64_t*>(bytes + sections.names);
+    if (names_length > length - sections.names - sizeof(uint64_t)) reject("truncated");
+
+    if (offsets[0] != 0 || offsets[vertices] != arcs) reject("corrupt");
+    for (size_t v = 0; v < vertices; v++) {
+        if (offsets[v] > offsets[v + 1]) reject("corrupt");
+    }
+    for (size_t arc = 0; arc < arcs; arc++) {
+        if (targets[arc] >= vertices) reject("corrupt");
+    }
+
+    /* Only the positions of the names are kept in memory, the names themselves stay in the mapping. */
+    if (names_length > 0) {
+        names = bytes + sections.names + sizeof(uint64_t);
+        name_offsets.reserve(vertices + 1);
+        name_offsets.push_back(0);
+        for (size_t i = 0; i < names_length; i++) {
+            if (names[i] == '\n') name_offsets.push_back(i + 1);
+        }
+        name_offsets.push_back(names_length + 1);
+        if (name_offsets.size() != vertices + 1) reject("corrupt");
+    }
+}
+
+mappedGraph::~mappedGraph() {
+    if (data) munmap(data, length);
+}
+
+std::string mappedGraph::Name(uint32_t v) const {
+    if (!names) return std::to_string(v);
+    return std::string(names + name_offsets[v], names + name_offsets[v + 1] - 1);
+}
+
+/**
+ * It writes an in-memory graph in the mapped format.
+ *
+ * Args:
+ *   g (compactGraph): the graph to write
+ *   path (string): the output file, overwritten if it exists
+ */
+void mappedGraph::Write(const compactGraph& g, const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("mappedGraph: cannot write " + path);
+
+    auto write_u64 = [&out](uint64_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    out.write(magic, sizeof(magic));
+    write_u64(g.size());
+    write_u64(g.ArcCount());
+    write_u64(g.Weighted() ? weighted_flag : 0);
+
+    for (auto offset : g.offsets) write_u64(offset);
+
+    out.write(reinterpret_cast<const char*>(g.targets.data()), g.targets.size() * sizeof(uint32_t));
+    out.write("\0\0\0\0", PaddedTo8(g.targets.size() * sizeof(uint32_t)) - g.targets.size() * sizeof(uint32_t));
+
+    if (g.Weighted()) {
+        for (auto weight : g.weights) write_u64(weight);
+    }
+
+    std::string names;
+    for (size_t v = 0; v < g.size(); v++) {
+        if (v) names += '\n';
+        names += g.name_of[v];
+    }
+    write_u64(names.size());
+    out.write(names.data(), names.size());
+
+    if (!out) throw std::runtime_error("mappedGraph: cannot write " + path);
+}
+
+/**
+ * It converts a text edge list into the mapped format without loading the edges into memory.
+ *
+ * The first pass counts the degree of every vertex, the second pass writes every arc straight into its slot of the
+ * mapped output file. Finally every row is sorted in place and parallel edges are merged into the lightest one, as
+ * basicGraph::Build does, and the file shrinks to the arcs that are left. Vertex ids are the numbers from the edge
+ * list, so the vertex count is the largest id plus one.
+ *
+ * Args:
+ *   edge_list_path (string): lines "u v" or "u v w"; either all lines or none of them have a weight
+ *   path (string): the output file, overwritten if it exists
+ */
+void mappedGraph::BuildFromEdgeList(const std::string& edge_list_path, const std::string& path) {
+    std::string line;
+    uint64_t from;
+    uint64_t to;
+    uint64_t weight;
+    bool has_weight;
+
+    /* First pass: the degrees, which give the offsets. */
+    std::vector<uint64_t> degree;
+    bool weighted = false;
+    size_t edges = 0;
+    {
+        std::ifstream in(edge_list_path);
+        if (!in) throw std::runtime_error("mappedGraph: cannot open " + edge_list_path);
+
+        while (ReadEdge(in, line, from, to, weight, has_weight)) {
+            if (edges == 0) weighted = has_weight;
+            if (has_weight != weighted) {
+                throw std::runtime_error("mappedGraph: edge \"" + line + "\" does not match the weights of the others");
+            }
+            if (std::max(from, to) >= npos) throw std::runtime_error("mappedGraph: vertex id out of range");
+
+            if (std::max(from, to) >= degree.size()) degree.resize(std::max(from, to) + 1, 0);
+            if (from != to) {
+                degree[from]++;
+                degree[to]++;
+            }
+            edges++;
+        }
+    }
+
+    size_t n = degree.size();
+    size_t arc_count = 0;
+    for (auto d : degree) arc_count += d;
+
+    layout sections(n, arc_count, weighted);
+    size_t file_length = sections.names + sizeof(uint64_t);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("mappedGraph: cannot write " + path);
+    if (ftruncate(fd, file_length) != 0) {
+        close(fd);
+        throw std::runtime_error("mappedGraph: cannot resize " + path);
+    }
+
+    void* output = mmap(nullptr, file_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (output == MAP_FAILED) throw std::runtime_error("mappedGraph: cannot map " + path);
+
+    char* bytes = static_cast<char*>(output);
+    auto* header = reinterpret_cast<uint64_t*>(bytes);
+    auto* out_offsets = reinterpret_cast<uint64_t*>(bytes + sections.offsets);
+    auto* out_targets = reinterpret_cast<uint32_t*>(bytes + sections.targets);
+    auto* out_weights = reinterpret_cast<uint64_t*>(bytes + sections.weights);
+
+    std::memcpy(bytes, magic, sizeof(magic));
+    header[1] = n;
+    header[2] = arc_count;
+    header[3] = weighted ? weighted_flag : 0;
+
+    out_offsets[0] = 0;
+    for (size_t v = 0; v < n; v++) {
+        out_offsets[v + 1] = out_offsets[v] + degree[v];
+    }
+
+    /* Second pass: every arc goes to the next free slot of its row, `degree` is reused as the row cursor. */
+    for (size_t v = 0; v < n; v++) {
+        degree[v] = out_offsets[v];
+    }
+
+    {
+        std::ifstream in(edge_list_path);
+        while (ReadEdge(in, line, from, to, weight, has_weight)) {
+            if (from == to) continue;
+            for (auto [u, v] : {std::pair(from, to), std::pair(to, from)}) {
+                size_t slot = degree[u]++;
+                out_targets[slot] = static_cast<uint32_t>(v);
+                if (weighted) out_weights[slot] = weight;
+            }
+        }
+    }
+
+    /* Sorting every row by target and weight, which keeps the scans of the algorithms monotone, and keeping the first
+    (lightest) arc to every target. The rows are compacted towards the front, so an arc never moves up. */
+    std::vector<std::pair<uint32_t, uint64_t>> row;
+    size_t kept = 0;
+    for (size_t v = 0; v < n; v++) {
+        row.clear();
+        for (size_t arc = out_offsets[v]; arc < out_offsets[v + 1]; arc++) {
+            row.emplace_back(out_targets[arc], weighted ? out_weights[arc] : 0);
+        }
+        std::sort(row.begin(), row.end());
+
+        out_offsets[v] = kept;
+        for (size_t i = 0; i < row.size(); i++) {
+            if (i > 0 && row[i].first == row[i - 1].first) continue;
+            out_targets[kept] = row[i].first;
+            if (weighted) out_weights[kept] = row[i].second;
+            kept++;
+        }
+    }
+    out_offsets[n] = kept;
+    header[2] = kept;
+
+    /* Moving the weights and the names down to the layout of the arcs that are left. */
+    layout compacted(n, kept, weighted);
+    std::memset(bytes + sections.targets + kept * sizeof(uint32_t), 0,
+                compacted.weights - sections.targets - kept * sizeof(uint32_t));
+    if (weighted) std::memmove(bytes + compacted.weights, out_weights, kept * sizeof(uint64_t));
+    *reinterpret_cast<uint64_t*>(bytes + compacted.names) = 0;
+
+    msync(output, file_length, MS_SYNC);
+    munmap(output, file_length);
+
+    if (truncate(path.c_str(), compacted.names + sizeof(uint64_t)) != 0) {
+        throw std::runtime_error("mappedGraph: cannot resize " + path);
+    }
+}
+
+/**
+ * It finds the eccentricity of the source with a level-synchronous BFS.
+ *
+ * Every level keeps its frontier as a list of ids sorted before it is expanded, so the offsets and targets of the
+ * level are read in increasing address order, and a level costs only its own vertices and arcs instead of a scan over
+ * all vertices.
+ *
+ * Args:
+ *   g (mappedGraph): the graph
+ *   source (uint32_t): the vertex to start from
+ *
+ * Returns:
+ *   The eccentricity of the source within its component.
+ */
+size_t StreamingEccentricity(const mappedGraph& g, uint32_t source) {
+    std::vector<uint64_t> visited((g.size() + 63) / 64, 0);
+    visited[source / 64] |= uint64_t(1) << (source % 64);
+
+    std::vector<uint32_t> frontier{source};
+    std::vector<uint32_t> next;
+
+    size_t eccentricity = 0;
+    for (;;) {
+        for (uint32_t v : frontier) {
+            for (uint32_t to : g.Neighbours(v)) {
+                uint64_t bit = uint64_t(1) << (to % 64);
+                if (visited[to / 64] & bit) continue;
+                visited[to / 64] |= bit;
+                next.push_back(to);
+            }
+        }
+        if (next.empty()) break;
+
+        eccentricity++;
+        std::sort(next.begin(), next.end());
+        frontier.swap(next);
+        next.clear();
+    }
+
+    return eccentricity;
+}
+
+/**
+ * It finds a minimum spanning forest with Boruvka's algorithm.
+ *
+ * Every round scans all arcs once and records the lightest arc leaving every component, then joins the components
+ * along those arcs. Ties are broken by the endpoints, so the chosen arcs never close a cycle. There are at most
+ * log2(V) rounds.
+ *
+ * Returns:
+ *   The edges of the forest, one spanning tree for every connected component.
+ */
+std::vector<mappedGraph::edge> StreamingMinimumSpanningForest(const mappedGraph& g) {
+    const size_t none = std::numeric_limits<size_t>::max();
+    size_t n = g.size();
+
+    std::vector<uint32_t> parent(n);
+    for (size_t v = 0; v < n; v++) parent[v] = v;
+
+    auto find = [&parent](uint32_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    auto key = [&g](uint32_t from, size_t arc) {
+        uint32_t to = g.targets[arc];
+        return std::make_tuple(g.WeightOf(arc), std::min(from, to), std::max(from, to));
+    };
+
+    std::vector<size_t> cheapest_arc(n);
+    std::vector<uint32_t> cheapest_from(n);
+    std::vector<mappedGraph::edge> forest;
+
+    while (true) {
+        std::fill(cheapest_arc.begin(), cheapest_arc.end(), none);
+
+        for (size_t v = 0; v < n; v++) {
+            uint32_t component = find(v);
+            for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+                if (find(g.targets[arc]) == component) continue;
+
+                if (cheapest_arc[component] == none ||
+                    key(v, arc) < key(cheapest_from[component], cheapest_arc[component])) {
+                    cheapest_arc[component] = arc;
+                    cheapest_from[component] = v;
+                }
+            }
+        }
+
+        size_t merged = 0;
+        for (size_t component = 0; component < n; component++) {
+            if (cheapest_arc[component] == none) continue;
+
+            uint32_t from = cheapest_from[component];
+            uint32_t to = g.targets[cheapest_arc[component]];
+            uint32_t a = find(from);
+            uint32_t b = find(to);
+            if (a == b) continue;
+
+            parent[a] = b;
+            forest.push_back({from, to, g.WeightOf(cheapest_arc[component])});
+            merged++;
+        }
+
+        if (merged == 0) break;
+    }
+
+    return forest;
+}
@@ -0,0 +1,90 @@
+#ifndef GRAPHSOLVER_MAPPEDGRAPH_H
+#define GRAPHSOLVER_MAPPEDGRAPH_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "basicGraph.h"
+
+//This is an undirected CSR graph that stays on disk: the offsets, targets and weights are memory-mapped from a file,
+//so only the pages that are being scanned occupy memory. It has the same read interface as basicGraph, so the
+//basicGraph function templates also work on it.
+//
+//File layout (little endian): the magic "GSCSR01", the vertex count, the arc count and the flags (8 bytes each),
+//then uint64 offsets[n + 1], uint32 targets[arcs] (padded to 8 bytes), uint64 weights[arcs] if weighted, and
+//finally the byte length of the names followed by the names separated by '\n' (length 0 if there are no names).
+class mappedGraph {
+public:
+    using id_type = uint32_t;
+    using weight_type = uint64_t;
+    using offset_type = uint64_t;
+    using edge = basicEdge<uint32_t, uint64_t>;
+
+    static constexpr bool directed = false;
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    struct neighbours {
+        const uint32_t* first;
+        const uint32_t* last;
+
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    const uint64_t* offsets = nullptr;
+    const uint32_t* targets = nullptr;
+    const uint64_t* weights = nullptr;
+
+    //Maps a graph file. Throws std::runtime_error if it is missing, truncated or not a valid graph file.
+    explicit mappedGraph(const std::string& path);
+
+    mappedGraph(const mappedGraph&) = delete;
+    mappedGraph& operator=(const mappedGraph&) = delete;
+
+    ~mappedGraph();
+
+    size_t size() const { return vertices; }
+
+    size_t ArcCount() const { return arcs; }
+
+    size_t EdgeCount() const { return arcs / 2; }
+
+    bool Weighted() const { return weights != nullptr; }
+
+    neighbours Neighbours(uint32_t v) const { return {targets + offsets[v], targets + offsets[v + 1]}; }
+
+    uint64_t WeightOf(size_t arc) const { return weights ? weights[arc] : 1; }
+
+    //The name of a vertex, or its decimal id if the file has no names.
+    std::string Name(uint32_t v) const;
+
+    //Writes an in-memory graph to the mapped format.
+    static void Write(const compactGraph& g, const std::string& path);
+
+    //Builds the mapped format from a text edge list with lines "u v" or "u v w" (decimal ids, one undirected edge per
+    //line) in two streaming passes, holding only O(V) counters in memory. Like basicGraph::Build it drops self-loops
+    //and keeps the lightest of parallel edges.
+    static void BuildFromEdgeList(const std::string& edge_list_path, const std::string& path);
+
+private:
+    void* data = nullptr;
+    size_t length = 0;
+    size_t vertices = 0;
+    size_t arcs = 0;
+    std::vector<size_t> name_offsets;
+    const char* names = nullptr;
+};
+
+//Finds the eccentricity of a vertex with a level-synchronous BFS that expands every level in id order, so the mapped
+//arrays are read front to back within a level. It costs O(V log V + E) whatever the diameter; working memory is one
+//visited bit per vertex and the ids of two levels.
+size_t StreamingEccentricity(const mappedGraph& g, uint32_t source);
+
+//Finds a minimum spanning forest with Boruvka's algorithm: every round is one sequential scan over all arcs, and the
+//working memory is O(V) no matter how many edges the file has.
+std::vector<mappedGraph::edge> StreamingMinimumSpanningForest(const mappedGraph& g);
+
+#endif //GRAPHSOLVER_MAPPEDGRAPH_H
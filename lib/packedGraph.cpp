@@ -0,0 +1,78 @@
+#include "packedGraph.h"
+
+#include <algorithm>
+#include <numeric>
+
+void packedGraph::AppendVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void packedGraph::IndexNames() {
+    by_name.resize(size());
+    std::iota(by_name.begin(), by_name.end(), 0);
+    std::sort(by_name.begin(), by_name.end(), [this](uint32_t lhs, uint32_t rhs) {
+        return Name(lhs) < Name(rhs);
+    });
+}
+
+uint32_t packedGraph::IdOf(std::string_view name) const {
+    auto it = std::lower_bound(by_name.begin(), by_name.end(), name, [this](uint32_t id, std::string_view key) {
+        return Name(id) < key;
+    });
+    return it != by_name.end() && Name(*it) == name ? *it : npos;
+}
+
+size_t packedGraph::MemoryUsage() const {
+    return sizeof(*this) + names.capacity() + name_offsets.capacity() * sizeof(uint32_t) +
+           by_name.capacity() * sizeof(uint32_t) + bytes.capacity() + offsets.capacity() * sizeof(uint64_t);
+}
+
+/**
+ * It finds a minimum spanning forest of the packed graph. Only the copy of every edge with from < to is collected,
+ * so the edge list takes half of the arcs.
+ *
+ * Returns:
+ *   The edges of the forest, one spanning tree for every connected component.
+ */
+std::vector<packedGraph::edge> MinimumSpanningForest(const packedGraph& g) {
+    std::vector<packedGraph::edge> edges;
+    edges.reserve(g.EdgeCount());
+    for (uint32_t v = 0; v < g.size(); v++) {
+        auto row = g.Neighbours(v);
+        for (auto it = row.begin(); it != row.end(); ++it) {
+            if (v < *it) edges.push_back({v, *it, it.Weight()});
+        }
+    }
+
+    std::stable_sort(edges.begin(), edges.end(), [](const packedGraph::edge& lhs, const packedGraph::edge& rhs) {
+        return lhs.weight < rhs.weight;
+    });
+
+    std::vector<uint32_t> parent(g.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    auto find = [&parent](uint32_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    std::vector<packedGraph::edge> forest;
+    for (const auto& e : edges) {
+        uint32_t a = find(e.from);
+        uint32_t b = find(e.to);
+        if (a == b) continue;
+
+        parent[a] = b;
+        forest.push_back(e);
+        if (forest.size() + 1 == g.size()) break;
+    }
+
+    return forest;
+}
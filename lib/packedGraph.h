@@ -0,0 +1,193 @@
+#ifndef GRAPHSOLVER_PACKEDGRAPH_H
+#define GRAPHSOLVER_PACKEDGRAPH_H
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "basicGraph.h"
+
+//This is an undirected graph compressed for keeping many graphs in memory. Every name is stored once in a single
+//buffer, and every adjacency row is a byte stream of varints: the degree of the vertex, then for every neighbour the
+//gap to the previous neighbour (the rows are sorted) followed by the weight of the edge if the graph is weighted. The rows are decoded while they are iterated, and the
+//read interface matches basicGraph, so Eccentricity and ConnectedComponents work on it unchanged.
+class packedGraph {
+public:
+    using id_type = uint32_t;
+    using weight_type = size_t;
+    using edge = basicEdge<uint32_t, size_t>;
+
+    static constexpr bool directed = false;
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    //Decodes one adjacency row. Dereferencing gives the neighbour, Weight() the weight of the edge to it.
+    class arcIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint32_t*;
+        using reference = uint32_t;
+
+        arcIterator(const uint8_t* position, const uint8_t* last, bool weighted)
+            : position(position), last(last), weighted(weighted) {
+            Decode();
+        }
+
+        uint32_t operator*() const { return to; }
+
+        size_t Weight() const { return weight; }
+
+        arcIterator& operator++() {
+            position = next;
+            Decode();
+            return *this;
+        }
+
+        bool operator==(const arcIterator& other) const { return position == other.position; }
+        bool operator!=(const arcIterator& other) const { return position != other.position; }
+
+    private:
+        const uint8_t* position;
+        const uint8_t* next = nullptr;
+        const uint8_t* last;
+        bool weighted;
+        uint32_t to = 0;
+        size_t weight = 1;
+
+        void Decode();
+    };
+
+    //A view of the neighbours of one vertex; `first` points at the degree that starts the row.
+    struct neighbours {
+        const uint8_t* first;
+        const uint8_t* last;
+        bool weighted;
+
+        arcIterator begin() const {
+            const uint8_t* position = first;
+            ReadVarint(position);
+            return {position, last, weighted};
+        }
+        arcIterator end() const { return {last, last, weighted}; }
+        //Reads the degree at the start of the row, so it does not decode the arcs.
+        size_t size() const {
+            const uint8_t* position = first;
+            return ReadVarint(position);
+        }
+    };
+
+    size_t size() const { return name_offsets.empty() ? 0 : name_offsets.size() - 1; }
+
+    size_t ArcCount() const { return arcs; }
+
+    size_t EdgeCount() const { return arcs / 2; }
+
+    bool Weighted() const { return weighted; }
+
+    neighbours Neighbours(uint32_t v) const {
+        return {bytes.data() + offsets[v], bytes.data() + offsets[v + 1], weighted};
+    }
+
+    std::string_view Name(uint32_t v) const {
+        return std::string_view(names).substr(name_offsets[v], name_offsets[v + 1] - name_offsets[v]);
+    }
+
+    //The id of a vertex, or npos if the graph has no vertex with this name (binary search over the sorted names).
+    uint32_t IdOf(std::string_view name) const;
+
+    //The bytes held by the graph, including the unused capacity of its buffers.
+    size_t MemoryUsage() const;
+
+    template <typename Graph>
+    static packedGraph Build(const Graph& g);
+
+private:
+    std::string names;
+    std::vector<uint32_t> name_offsets;
+    std::vector<uint32_t> by_name;
+    std::vector<uint8_t> bytes;
+    std::vector<uint64_t> offsets;
+    size_t arcs = 0;
+    bool weighted = false;
+
+    static void AppendVarint(std::vector<uint8_t>& out, uint64_t value);
+
+    //Reads 7 bits per byte, least significant first; the last byte of a varint has the high bit clear.
+    static uint64_t ReadVarint(const uint8_t*& position) {
+        uint64_t value = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            uint8_t byte = *position++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
+
+    void IndexNames();
+};
+
+inline void packedGraph::arcIterator::Decode() {
+    if (position == last) return;
+    next = position;
+    to += static_cast<uint32_t>(ReadVarint(next));
+    if (weighted) weight = ReadVarint(next);
+}
+
+/**
+ * It packs an undirected basicGraph (or any graph with the same read interface). The rows of basicGraph are sorted,
+ * so the gaps between neighbours are small when the ids of neighbours are close (see Reorder).
+ *
+ * Args:
+ *   g (Graph): the graph, for example `solver.Compact()`
+ *
+ * Returns:
+ *   The packed graph. Throws std::length_error if the names take more than 4 GiB.
+ */
+template <typename Graph>
+packedGraph packedGraph::Build(const Graph& g) {
+    static_assert(!Graph::directed, "packedGraph stores undirected graphs");
+
+    packedGraph packed;
+    packed.weighted = g.Weighted();
+    packed.arcs = g.ArcCount();
+
+    size_t name_bytes = 0;
+    for (const auto& name : g.name_of) name_bytes += name.size();
+    if (name_bytes > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("packedGraph: the names take more than 4 GiB");
+    }
+
+    packed.names.reserve(name_bytes);
+    packed.name_offsets.reserve(g.size() + 1);
+    packed.name_offsets.push_back(0);
+    for (const auto& name : g.name_of) {
+        packed.names += name;
+        packed.name_offsets.push_back(static_cast<uint32_t>(packed.names.size()));
+    }
+
+    packed.offsets.reserve(g.size() + 1);
+    packed.offsets.push_back(0);
+    for (size_t v = 0; v < g.size(); v++) {
+        uint64_t previous = 0;
+        AppendVarint(packed.bytes, g.offsets[v + 1] - g.offsets[v]);
+        for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+            AppendVarint(packed.bytes, g.targets[arc] - previous);
+            if (packed.weighted) AppendVarint(packed.bytes, g.WeightOf(arc));
+            previous = g.targets[arc];
+        }
+        packed.offsets.push_back(packed.bytes.size());
+    }
+    packed.bytes.shrink_to_fit();
+
+    packed.IndexNames();
+    return packed;
+}
+
+//Finds a minimum spanning forest with Kruskal's algorithm, decoding every row once to collect the edges.
+std::vector<packedGraph::edge> MinimumSpanningForest(const packedGraph& g);
+
+#endif //GRAPHSOLVER_PACKEDGRAPH_H
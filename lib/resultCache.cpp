@@ -0,0 +1,170 @@
+#include "resultCache.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    const char* header = "graphSolver-cache 1";
+
+    std::string Key(uint64_t fingerprint, const std::string& query) {
+        std::ostringstream key;
+        key << std::hex << fingerprint << '\t' << query;
+        return key.str();
+    }
+
+    std::string Escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '\\') escaped += "\\\\";
+            else if (c == '\n') escaped += "\\n";
+            else if (c == '\t') escaped += "\\t";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    std::string Unescape(const std::string& text) {
+        std::string unescaped;
+        for (size_t i = 0; i < text.size(); i++) {
+            if (text[i] != '\\' || i + 1 == text.size()) {
+                unescaped += text[i];
+                continue;
+            }
+
+            char c = text[++i];
+            unescaped += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+        }
+        return unescaped;
+    }
+}
+
+resultCache::resultCache(const resultCache& other) {
+    *this = other;
+}
+
+resultCache& resultCache::operator=(const resultCache& other) {
+    if (this == &other) return *this;
+
+    std::scoped_lock both(lock, other.lock);
+    hits = other.hits;
+    misses = other.misses;
+    entries = other.entries;
+    file = other.file;
+    return *this;
+}
+
+/**
+ * It looks up the result of a query on the graph with the given fingerprint.
+ *
+ * Args:
+ *   fingerprint (uint64_t): the fingerprint of the graph
+ *   query (string): the name of the query, including its arguments
+ *   result (string): receives the cached result
+ *
+ * Returns:
+ *   True on a hit.
+ */
+bool resultCache::Get(uint64_t fingerprint, const std::string& query, std::string& result) {
+    std::string key = Key(fingerprint, query);
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+
+    hits++;
+    result = it->second;
+    return true;
+}
+
+/**
+ * It stores the result of a query, and appends it to the cache file if one is open.
+ */
+void resultCache::Put(uint64_t fingerprint, const std::string& query, const std::string& result) {
+    std::string key = Key(fingerprint, query);
+    std::lock_guard<std::mutex> guard(lock);
+    entries[key] = result;
+
+    if (file.empty()) return;
+
+    std::ofstream out(file, std::ios::app);
+    std::ostringstream hex;
+    hex << std::hex << fingerprint;
+    out << hex.str() << '\t' << Escape(query) << '\t' << Escape(result) << '\n';
+}
+
+/**
+ * It loads the cache file, creating it if it does not exist or is empty. Later entries of the file win over earlier
+ * ones, and lines that do not parse, such as one torn by a crash in the middle of a Put, are skipped.
+ *
+ * A file that does not start with the header (another file, or a cache of another format version) is left untouched:
+ * the cache then stays in memory only.
+ *
+ * Args:
+ *   path (string): the cache file
+ */
+void resultCache::Open(const std::string& path) {
+    std::lock_guard<std::mutex> guard(lock);
+    file.clear();
+
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+
+    if (!in || in.peek() == std::ifstream::traits_type::eof()) {
+        in.close();
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return;
+        out << header << '\n';
+        file = path;
+        return;
+    }
+
+    if (!std::getline(in, line) || line != header) return;
+    file = path;
+
+    bool ends_with_newline = !in.eof();
+    while (std::getline(in, line)) {
+        ends_with_newline = !in.eof();
+
+        size_t first_tab = line.find('\t');
+        size_t second_tab = line.find('\t', first_tab + 1);
+        if (first_tab == 0 || first_tab == std::string::npos || second_tab == std::string::npos) continue;
+
+        std::string digits = line.substr(0, first_tab);
+        char* digits_end = nullptr;
+        errno = 0;
+        uint64_t fingerprint = std::strtoull(digits.c_str(), &digits_end, 16);
+        if (errno || *digits_end || !std::isxdigit(static_cast<unsigned char>(digits[0]))) continue;
+
+        std::string query = Unescape(line.substr(first_tab + 1, second_tab - first_tab - 1));
+        entries[Key(fingerprint, query)] = Unescape(line.substr(second_tab + 1));
+    }
+
+    /* A torn last line is closed, so the next Put starts on a line of its own. */
+    if (!ends_with_newline) std::ofstream(path, std::ios::app) << '\n';
+}
+
+void resultCache::Clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    hits = 0;
+    misses = 0;
+}
+
+size_t resultCache::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return entries.size();
+}
+
+uint64_t HashBytes(const std::string& bytes, uint64_t hash) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
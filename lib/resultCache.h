@@ -0,0 +1,49 @@
+#ifndef GRAPHSOLVER_RESULTCACHE_H
+#define GRAPHSOLVER_RESULTCACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//This is a cache of serialized query results, keyed by the fingerprint of the graph and the name of the query.
+//It can be backed by a file, so that another process working on the same graph also gets hits.
+//
+//File format: the line "graphSolver-cache 1", then one entry per line: the fingerprint in hex, the query and the
+//result, separated by tabs. Tabs, newlines and backslashes inside the query and the result are escaped.
+//
+//All members are safe to call from several threads at once.
+class resultCache {
+public:
+    size_t hits = 0;
+    size_t misses = 0;
+
+    resultCache() = default;
+
+    resultCache(const resultCache& other);
+
+    resultCache& operator=(const resultCache& other);
+
+    bool Get(uint64_t fingerprint, const std::string& query, std::string& result);
+
+    void Put(uint64_t fingerprint, const std::string& query, const std::string& result);
+
+    //Loads the entries of the file (if it exists) and appends every later Put to it. A file that is not a cache of
+    //this format version is not read or written; the cache then stays in memory only.
+    void Open(const std::string& path);
+
+    //Forgets the entries in memory; the file, if any, is left as it is.
+    void Clear();
+
+    size_t size() const;
+
+private:
+    std::unordered_map<std::string, std::string> entries;
+    std::string file;
+    mutable std::mutex lock;
+};
+
+//64-bit FNV-1a hashing, used for graph fingerprints.
+uint64_t HashBytes(const std::string& bytes, uint64_t hash = 14695981039346656037ull);
+
+#endif //GRAPHSOLVER_RESULTCACHE_H
@@ -0,0 +1,624 @@
+#include "routeInspection.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace {
+    const size_t unreachable = std::numeric_limits<size_t>::max();
+
+    //Edmonds' weighted blossom algorithm for a maximum-weight matching of a complete graph, with the primal-dual
+    //updates of Gabow's O(n^3) formulation. The vertices are 1..n and the blossoms n+1..2n; g[b][x] keeps the best
+    //edge between two top-level blossoms and flower_from[b][x] the sub-blossom of b that contains vertex x.
+    struct weightedBlossom {
+        struct edge {
+            int u;
+            int v;
+            int64_t w;
+        };
+
+        int n;
+        int n_x;
+        std::vector<std::vector<edge>> g;
+        std::vector<int64_t> lab;
+        std::vector<int> match;
+        std::vector<int> slack;
+        std::vector<int> st;
+        std::vector<int> pa;
+        std::vector<int> S;
+        std::vector<int> vis;
+        std::vector<std::vector<int>> flower_from;
+        std::vector<std::vector<int>> flower;
+        std::deque<int> q;
+        int vis_time = 0;
+        searchMonitor monitor;
+
+        weightedBlossom(const std::vector<std::vector<int64_t>>& weight, const searchBudget& budget)
+            : n(static_cast<int>(weight.size())), n_x(n), monitor(budget) {
+            size_t size = 2 * weight.size() + 1;
+            g.assign(size, std::vector<edge>(size, {0, 0, 0}));
+            for (int u = 1; u <= n; u++) {
+                for (int v = 1; v <= n; v++) {
+                    g[u][v] = {u, v, u == v ? 0 : weight[u - 1][v - 1]};
+                }
+            }
+
+            lab.assign(size, 0);
+            match.assign(size, 0);
+            slack.assign(size, 0);
+            st.assign(size, 0);
+            pa.assign(size, 0);
+            S.assign(size, 0);
+            vis.assign(size, 0);
+            flower_from.assign(size, std::vector<int>(n + 1, 0));
+            flower.assign(size, {});
+        }
+
+        /* The reduced cost of an edge, doubled so that the dual updates stay integral. */
+        int64_t Reduced(const edge& e) const {
+            return lab[e.u] + lab[e.v] - e.w * 2;
+        }
+
+        void UpdateSlack(int u, int x) {
+            if (!slack[x] || Reduced(g[u][x]) < Reduced(g[slack[x]][x])) slack[x] = u;
+        }
+
+        void SetSlack(int x) {
+            slack[x] = 0;
+            for (int u = 1; u <= n; u++) {
+                if (g[u][x].w > 0 && st[u] != x && S[st[u]] == 0) UpdateSlack(u, x);
+            }
+        }
+
+        void Push(int x) {
+            if (x <= n) {
+                q.push_back(x);
+                return;
+            }
+            for (int sub : flower[x]) Push(sub);
+        }
+
+        void SetTop(int x, int b) {
+            st[x] = b;
+            if (x <= n) return;
+            for (int sub : flower[x]) SetTop(sub, b);
+        }
+
+        /* The position of xr in the cycle of b, reversing the cycle if needed so that the position is even. */
+        int EvenPosition(int b, int xr) {
+            int pr = static_cast<int>(std::find(flower[b].begin(), flower[b].end(), xr) - flower[b].begin());
+            if (pr % 2 == 1) {
+                std::reverse(flower[b].begin() + 1, flower[b].end());
+                return static_cast<int>(flower[b].size()) - pr;
+            }
+            return pr;
+        }
+
+        void SetMatch(int u, int v) {
+            match[u] = g[u][v].v;
+            if (u <= n) return;
+
+            edge e = g[u][v];
+            int xr = flower_from[u][e.u];
+            int pr = EvenPosition(u, xr);
+            for (int i = 0; i < pr; i++) SetMatch(flower[u][i], flower[u][i ^ 1]);
+            SetMatch(xr, v);
+            std::rotate(flower[u].begin(), flower[u].begin() + pr, flower[u].end());
+        }
+
+        void Augment(int u, int v) {
+            while (true) {
+                int xnv = st[match[u]];
+                SetMatch(u, v);
+                if (!xnv) return;
+                SetMatch(xnv, st[pa[xnv]]);
+                u = st[pa[xnv]];
+                v = xnv;
+            }
+        }
+
+        int LowestCommonAncestor(int u, int v) {
+            for (++vis_time; u || v; std::swap(u, v)) {
+                if (u == 0) continue;
+                if (vis[u] == vis_time) return u;
+                vis[u] = vis_time;
+                u = st[match[u]];
+                if (u) u = st[pa[u]];
+            }
+            return 0;
+        }
+
+        void AddBlossom(int u, int lca, int v) {
+            int b = n + 1;
+            while (b <= n_x && st[b]) b++;
+            if (b > n_x) n_x++;
+
+            lab[b] = 0;
+            S[b] = 0;
+            match[b] = match[lca];
+            flower[b].assign(1, lca);
+            for (int x = u, y; x != lca; x = st[pa[y]]) {
+                flower[b].push_back(x);
+                flower[b].push_back(y = st[match[x]]);
+                Push(y);
+            }
+            std::reverse(flower[b].begin() + 1, flower[b].end());
+            for (int x = v, y; x != lca; x = st[pa[y]]) {
+                flower[b].push_back(x);
+                flower[b].push_back(y = st[match[x]]);
+                Push(y);
+            }
+            SetTop(b, b);
+
+            for (int x = 1; x <= n_x; x++) g[b][x].w = g[x][b].w = 0;
+            for (int x = 1; x <= n; x++) flower_from[b][x] = 0;
+            for (int xs : flower[b]) {
+                for (int x = 1; x <= n_x; x++) {
+                    if (g[b][x].w == 0 || Reduced(g[xs][x]) < Reduced(g[b][x])) {
+                        g[b][x] = g[xs][x];
+                        g[x][b] = g[x][xs];
+                    }
+                }
+                for (int x = 1; x <= n; x++) {
+                    if (flower_from[xs][x]) flower_from[b][x] = xs;
+                }
+            }
+            SetSlack(b);
+        }
+
+        void ExpandBlossom(int b) {
+            for (int sub : flower[b]) SetTop(sub, sub);
+
+            int xr = flower_from[b][g[b][pa[b]].u];
+            int pr = EvenPosition(b, xr);
+            for (int i = 0; i < pr; i += 2) {
+                int xs = flower[b][i];
+                int xns = flower[b][i + 1];
+                pa[xs] = g[xns][xs].u;
+                S[xs] = 1;
+                S[xns] = 0;
+                slack[xs] = 0;
+                SetSlack(xns);
+                Push(xns);
+            }
+            S[xr] = 1;
+            pa[xr] = pa[b];
+            for (size_t i = pr + 1; i < flower[b].size(); i++) {
+                int xs = flower[b][i];
+                S[xs] = -1;
+                SetSlack(xs);
+            }
+            st[b] = 0;
+        }
+
+        /* Returns true if the tight edge completed an augmenting path. */
+        bool OnTightEdge(const edge& e) {
+            int u = st[e.u];
+            int v = st[e.v];
+            if (S[v] == -1) {
+                pa[v] = e.u;
+                S[v] = 1;
+                int nu = st[match[v]];
+                slack[v] = slack[nu] = 0;
+                S[nu] = 0;
+                Push(nu);
+            } else if (S[v] == 0) {
+                int lca = LowestCommonAncestor(u, v);
+                if (!lca) {
+                    Augment(u, v);
+                    Augment(v, u);
+                    return true;
+                }
+                AddBlossom(u, lca, v);
+            }
+            return false;
+        }
+
+        /* One phase: grows alternating trees and adjusts the duals until an augmenting path is found. It gives up when
+        the budget runs out, which the caller sees in monitor.stopped. */
+        bool Phase() {
+            std::fill(S.begin() + 1, S.begin() + n_x + 1, -1);
+            std::fill(slack.begin() + 1, slack.begin() + n_x + 1, 0);
+            q.clear();
+            for (int x = 1; x <= n_x; x++) {
+                if (st[x] == x && !match[x]) {
+                    pa[x] = 0;
+                    S[x] = 0;
+                    Push(x);
+                }
+            }
+            if (q.empty()) return false;
+
+            while (true) {
+                while (!q.empty()) {
+                    if (monitor.Stop(0, 0)) return false;
+                    int u = q.front();
+                    q.pop_front();
+                    if (S[st[u]] == 1) continue;
+                    for (int v = 1; v <= n; v++) {
+                        if (g[u][v].w > 0 && st[u] != st[v]) {
+                            if (Reduced(g[u][v]) == 0) {
+                                if (OnTightEdge(g[u][v])) return true;
+                            } else {
+                                UpdateSlack(u, st[v]);
+                            }
+                        }
+                    }
+                }
+
+                if (monitor.Stop(0, 0)) return false;
+
+                int64_t d = std::numeric_limits<int64_t>::max();
+                for (int b = n + 1; b <= n_x; b++) {
+                    if (st[b] == b && S[b] == 1) d = std::min(d, lab[b] / 2);
+                }
+                for (int x = 1; x <= n_x; x++) {
+                    if (st[x] == x && slack[x]) {
+                        if (S[x] == -1) d = std::min(d, Reduced(g[slack[x]][x]));
+                        else if (S[x] == 0) d = std::min(d, Reduced(g[slack[x]][x]) / 2);
+                    }
+                }
+
+                for (int u = 1; u <= n; u++) {
+                    if (S[st[u]] == 0) {
+                        if (lab[u] <= d) return false;
+                        lab[u] -= d;
+                    } else if (S[st[u]] == 1) {
+                        lab[u] += d;
+                    }
+                }
+                for (int b = n + 1; b <= n_x; b++) {
+                    if (st[b] != b) continue;
+                    if (S[b] == 0) lab[b] += d * 2;
+                    else if (S[b] == 1) lab[b] -= d * 2;
+                }
+
+                q.clear();
+                for (int x = 1; x <= n_x; x++) {
+                    if (st[x] == x && slack[x] && st[slack[x]] != x && Reduced(g[slack[x]][x]) == 0) {
+                        if (OnTightEdge(g[slack[x]][x])) return true;
+                    }
+                }
+                for (int b = n + 1; b <= n_x; b++) {
+                    if (st[b] == b && S[b] == 1 && lab[b] == 0) ExpandBlossom(b);
+                }
+            }
+        }
+
+        std::vector<size_t> Solve() {
+            int64_t w_max = 0;
+            for (int u = 0; u <= n; u++) st[u] = u;
+            for (int u = 1; u <= n; u++) {
+                for (int v = 1; v <= n; v++) {
+                    flower_from[u][v] = u == v ? u : 0;
+                    w_max = std::max(w_max, g[u][v].w);
+                }
+            }
+            for (int u = 1; u <= n; u++) lab[u] = w_max;
+
+            while (Phase()) {}
+            if (monitor.stopped) return {};
+
+            std::vector<size_t> mate(n);
+            for (int u = 1; u <= n; u++) mate[u - 1] = match[u] - 1;
+            return mate;
+        }
+    };
+
+    //The shortest distances from one source, stopping once `targets` of the target vertices are settled.
+    struct shortestPaths {
+        std::vector<size_t> dist;
+        std::vector<size_t> parent_arc;
+        std::vector<uint32_t> settled_targets;     //in the order they were settled, so by increasing distance
+    };
+
+    void Dijkstra(const compactGraph& g, uint32_t source, const std::vector<bool>& is_target, size_t targets,
+                  shortestPaths& paths) {
+        using entry = std::pair<size_t, uint32_t>;
+
+        paths.dist.assign(g.size(), unreachable);
+        paths.parent_arc.assign(g.size(), unreachable);
+        paths.settled_targets.clear();
+
+        std::priority_queue<entry, std::vector<entry>, std::greater<>> heap;
+        paths.dist[source] = 0;
+        heap.push({0, source});
+
+        while (!heap.empty() && targets) {
+            auto [dist, v] = heap.top();
+            heap.pop();
+            if (dist != paths.dist[v]) continue;
+            if (is_target[v]) {
+                paths.settled_targets.push_back(v);
+                targets--;
+            }
+
+            for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+                uint32_t to = g.targets[arc];
+                size_t next = dist + g.WeightOf(arc);
+                if (next < paths.dist[to]) {
+                    paths.dist[to] = next;
+                    paths.parent_arc[to] = arc;
+                    heap.push({next, to});
+                }
+            }
+        }
+    }
+
+    /**
+     * It pairs the odd vertices like GreedyPerfectMatching, but without the k x k distance matrix. Dijkstra from
+     * every odd vertex only runs until its `candidates` nearest odd vertices are settled. The candidate pairs are
+     * taken shortest first, every vertex left over is paired with the nearest unpaired odd vertex by one more
+     * Dijkstra, and then two pairs swap partners while that makes them shorter and the new distances are known.
+     *
+     * Returns:
+     *   mate[i], the index in `odd` of the vertex paired with odd[i].
+     */
+    std::vector<size_t> SparseGreedyMatching(const compactGraph& g, const std::vector<uint32_t>& odd,
+                                             const std::vector<bool>& is_odd, size_t candidates) {
+        size_t k = odd.size();
+        std::vector<size_t> index_of(g.size(), unreachable);
+        for (size_t i = 0; i < k; i++) index_of[odd[i]] = i;
+
+        std::vector<std::vector<std::pair<size_t, size_t>>> nearest(k);    //(distance, index) by distance
+        shortestPaths paths;
+        for (size_t i = 0; i < k; i++) {
+            Dijkstra(g, odd[i], is_odd, candidates + 1, paths);
+            for (uint32_t v : paths.settled_targets) {
+                if (v != odd[i]) nearest[i].emplace_back(paths.dist[v], index_of[v]);
+            }
+        }
+
+        auto known = [&](size_t u, size_t v) {
+            for (auto [dist, w] : nearest[u]) if (w == v) return dist;
+            for (auto [dist, w] : nearest[v]) if (w == u) return dist;
+            return unreachable;
+        };
+
+        std::vector<std::tuple<size_t, size_t, size_t>> pairs;
+        for (size_t i = 0; i < k; i++) {
+            for (auto [dist, j] : nearest[i]) {
+                if (i < j) pairs.emplace_back(dist, i, j);
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+
+        std::vector<size_t> mate(k, unreachable);
+        std::vector<size_t> pair_cost(k, 0);
+        for (auto [dist, i, j] : pairs) {
+            if (mate[i] != unreachable || mate[j] != unreachable) continue;
+            mate[i] = j, mate[j] = i;
+            pair_cost[i] = pair_cost[j] = dist;
+        }
+        std::vector<std::tuple<size_t, size_t, size_t>>().swap(pairs);
+
+        /* The vertices whose candidates were all taken search for the nearest unpaired odd vertex. */
+        std::vector<bool> unpaired(g.size(), false);
+        for (size_t i = 0; i < k; i++) unpaired[odd[i]] = mate[i] == unreachable;
+        for (size_t i = 0; i < k; i++) {
+            if (mate[i] != unreachable) continue;
+
+            unpaired[odd[i]] = false;
+            Dijkstra(g, odd[i], unpaired, 1, paths);
+            uint32_t partner = paths.settled_targets.front();
+            unpaired[partner] = false;
+
+            size_t j = index_of[partner];
+            mate[i] = j, mate[j] = i;
+            pair_cost[i] = pair_cost[j] = paths.dist[partner];
+        }
+
+        /* The pairs (a, b) and (c, d), with c a candidate of a, become (a, c) (b, d) while that is shorter. */
+        for (bool improved = true; improved;) {
+            improved = false;
+            for (size_t a = 0; a < k; a++) {
+                for (auto [ac, c] : nearest[a]) {
+                    size_t b = mate[a];
+                    if (c == b) continue;
+
+                    size_t d = mate[c];
+                    size_t bd = known(b, d);
+                    if (bd == unreachable || ac + bd >= pair_cost[a] + pair_cost[c]) continue;
+
+                    mate[a] = c, mate[c] = a, mate[b] = d, mate[d] = b;
+                    pair_cost[a] = pair_cost[c] = ac;
+                    pair_cost[b] = pair_cost[d] = bd;
+                    improved = true;
+                }
+            }
+        }
+
+        return mate;
+    }
+}
+
+std::vector<size_t> MinimumWeightPerfectMatching(const std::vector<std::vector<size_t>>& cost,
+                                                 const searchBudget& budget) {
+    size_t n = cost.size();
+    if (n % 2) throw std::invalid_argument("MinimumWeightPerfectMatching: the number of vertices is odd");
+    if (n == 0) return {};
+
+    /* Maximizing big - cost with big > n/2 * max cost: every perfect matching then outweighs every smaller one. */
+    size_t max_cost = 0;
+    for (const auto& row : cost) {
+        for (size_t c : row) max_cost = std::max(max_cost, c);
+    }
+    int64_t big = static_cast<int64_t>(max_cost) * static_cast<int64_t>(n / 2 + 1) + 1;
+
+    std::vector<std::vector<int64_t>> weight(n, std::vector<int64_t>(n));
+    for (size_t u = 0; u < n; u++) {
+        for (size_t v = 0; v < n; v++) {
+            weight[u][v] = big - static_cast<int64_t>(cost[u][v]);
+        }
+    }
+
+    return weightedBlossom(weight, budget).Solve();
+}
+
+std::vector<size_t> GreedyPerfectMatching(const std::vector<std::vector<size_t>>& cost) {
+    size_t n = cost.size();
+    if (n % 2) throw std::invalid_argument("GreedyPerfectMatching: the number of vertices is odd");
+
+    std::vector<size_t> mate(n, unreachable);
+    for (size_t u = 0; u < n; u++) {
+        if (mate[u] != unreachable) continue;
+
+        size_t nearest = unreachable;
+        for (size_t v = u + 1; v < n; v++) {
+            if (mate[v] == unreachable && (nearest == unreachable || cost[u][v] < cost[u][nearest])) nearest = v;
+        }
+        mate[u] = nearest;
+        mate[nearest] = u;
+    }
+
+    /* Two pairs (a, b) and (c, d) swap partners if (a, c) (b, d) or (a, d) (b, c) is shorter, until no swap helps. */
+    std::vector<size_t> pairs;
+    for (size_t u = 0; u < n; u++) {
+        if (u < mate[u]) pairs.push_back(u);
+    }
+
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            for (size_t j = i + 1; j < pairs.size(); j++) {
+                size_t a = pairs[i], b = mate[a];
+                size_t c = pairs[j], d = mate[c];
+                size_t current = cost[a][b] + cost[c][d];
+
+                if (cost[a][c] + cost[b][d] < current && cost[a][c] + cost[b][d] <= cost[a][d] + cost[b][c]) {
+                    mate[a] = c, mate[c] = a, mate[b] = d, mate[d] = b;
+                    pairs[j] = b;
+                    improved = true;
+                } else if (cost[a][d] + cost[b][c] < current) {
+                    mate[a] = d, mate[d] = a, mate[b] = c, mate[c] = b;
+                    pairs[j] = b;
+                    improved = true;
+                }
+            }
+        }
+    }
+
+    return mate;
+}
+
+postmanWalk PostmanWalk(const compactGraph& g, uint32_t start, size_t exact_limit, const searchBudget& budget) {
+    postmanWalk result;
+
+    /* The component of the start, found by BFS. */
+    std::vector<bool> in_component(g.size(), false);
+    std::vector<uint32_t> component(1, start);
+    in_component[start] = true;
+    for (size_t head = 0; head < component.size(); head++) {
+        for (uint32_t to : g.Neighbours(component[head])) {
+            if (in_component[to]) continue;
+            in_component[to] = true;
+            component.push_back(to);
+        }
+    }
+
+    /* Every edge of the component once, as arcs with from < to, plus the repeated shortest paths later. */
+    std::vector<compactGraph::edge> edges;
+    std::vector<uint32_t> odd;
+    std::vector<bool> is_odd(g.size(), false);
+    for (uint32_t v : component) {
+        for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+            if (v < g.targets[arc]) {
+                edges.push_back({v, g.targets[arc], g.WeightOf(arc)});
+                result.length += g.WeightOf(arc);
+            }
+        }
+        if (g.Neighbours(v).size() % 2) {
+            odd.push_back(v);
+            is_odd[v] = true;
+        }
+    }
+    result.odd_vertices = odd.size();
+
+    /* The odd vertices are paired on their shortest distances: exactly on the full matrix up to exact_limit of them,
+    otherwise greedily on the distances to their nearest odd vertices only. */
+    size_t k = odd.size();
+    std::vector<size_t> mate;
+    shortestPaths paths;
+
+    if (k <= exact_limit) {
+        std::vector<std::vector<size_t>> cost(k, std::vector<size_t>(k, 0));
+        for (size_t i = 0; i < k; i++) {
+            Dijkstra(g, odd[i], is_odd, k, paths);
+            for (size_t j = 0; j < k; j++) cost[i][j] = paths.dist[odd[j]];
+        }
+
+        mate = MinimumWeightPerfectMatching(cost, budget);
+        if (mate.size() != k) {
+            mate = GreedyPerfectMatching(cost);
+            result.optimal = false;
+        }
+    } else {
+        mate = SparseGreedyMatching(g, odd, is_odd, postman_candidates);
+        result.optimal = false;
+    }
+
+    /* Repeating the edges of the shortest path between every pair. */
+    for (size_t i = 0; i < k; i++) {
+        if (mate[i] < i) continue;
+
+        std::vector<bool> is_target(g.size(), false);
+        uint32_t target = odd[mate[i]];
+        is_target[target] = true;
+        Dijkstra(g, odd[i], is_target, 1, paths);
+
+        for (uint32_t v = target; v != odd[i];) {
+            size_t arc = paths.parent_arc[v];
+            uint32_t from = static_cast<uint32_t>(std::upper_bound(g.offsets.begin(), g.offsets.end(), arc) -
+                                                  g.offsets.begin() - 1);
+            edges.push_back({from, v, g.WeightOf(arc)});
+            result.length += g.WeightOf(arc);
+            result.repeated++;
+            v = from;
+        }
+    }
+
+    /* Hierholzer's algorithm on the multigraph, with the edges by id so that repeated edges are distinct. */
+    std::vector<size_t> first(g.size() + 1, 0);
+    for (const auto& e : edges) {
+        first[e.from + 1]++;
+        first[e.to + 1]++;
+    }
+    for (size_t v = 0; v < g.size(); v++) first[v + 1] += first[v];
+
+    std::vector<size_t> incident(2 * edges.size());
+    std::vector<size_t> fill(first.begin(), first.end() - 1);
+    for (size_t id = 0; id < edges.size(); id++) {
+        incident[fill[edges[id].from]++] = id;
+        incident[fill[edges[id].to]++] = id;
+    }
+
+    std::vector<bool> used(edges.size(), false);
+    std::vector<size_t> next(first.begin(), first.end() - 1);
+    std::vector<uint32_t> stack(1, start);
+    std::vector<uint32_t> circuit;
+
+    while (!stack.empty()) {
+        uint32_t v = stack.back();
+        while (next[v] < first[v + 1] && used[incident[next[v]]]) next[v]++;
+
+        if (next[v] == first[v + 1]) {
+            circuit.push_back(v);
+            stack.pop_back();
+            continue;
+        }
+
+        size_t id = incident[next[v]++];
+        used[id] = true;
+        stack.push_back(edges[id].from == v ? edges[id].to : edges[id].from);
+    }
+
+    result.walk.reserve(circuit.size());
+    for (auto it = circuit.rbegin(); it != circuit.rend(); ++it) result.walk.push_back(g.name_of[*it]);
+
+    return result;
+}
@@ -0,0 +1,68 @@
+#ifndef GRAPHSOLVER_ROUTEINSPECTION_H
+#define GRAPHSOLVER_ROUTEINSPECTION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "anytimeSearch.h"
+#include "basicGraph.h"
+
+//A closed walk that traverses every edge of a connected component at least once (the Chinese postman tour).
+struct postmanWalk {
+    std::vector<std::string> walk;      //the countries in order, the first one is repeated at the end
+    size_t length = 0;                  //the total weight of the walk, repeated edges included
+    size_t repeated = 0;                //the number of edge traversals added to make the degrees even
+    size_t odd_vertices = 0;
+    bool optimal = true;                //false if the odd vertices were paired heuristically
+};
+
+//Odd vertices are paired exactly (weighted blossom algorithm) up to this count. Above it the pairing is greedy on the
+//distances to the postman_candidates nearest odd vertices of each, then improved by exchanging partners, which needs
+//O(k * postman_candidates) memory instead of the O(k^2) distance matrix.
+constexpr size_t postman_exact_limit = 1000;
+constexpr size_t postman_candidates = 16;
+
+/**
+ * It finds a minimum-weight perfect matching of a complete graph with an even number of vertices, with Edmonds'
+ * weighted blossom algorithm in O(n^3) time and O(n^2) memory.
+ *
+ * Args:
+ *   cost (vector<vector<size_t>>): the symmetric cost matrix
+ *   budget (searchBudget): the limits of the search; every scanned vertex of the blossom algorithm counts as a node
+ *
+ * Returns:
+ *   mate[v], the vertex matched with v, or an empty vector if the budget ran out first.
+ */
+std::vector<size_t> MinimumWeightPerfectMatching(const std::vector<std::vector<size_t>>& cost,
+                                                 const searchBudget& budget = searchBudget());
+
+/**
+ * It finds a short perfect matching of a complete graph: nearest-neighbour pairs, then pairs of pairs exchange
+ * partners while that makes them shorter.
+ *
+ * Returns:
+ *   mate[v], the vertex matched with v.
+ */
+std::vector<size_t> GreedyPerfectMatching(const std::vector<std::vector<size_t>>& cost);
+
+/**
+ * It finds the shortest closed walk from `start` that traverses every edge of its connected component.
+ *
+ * The odd-degree vertices are paired by a minimum-weight perfect matching on their shortest-path distances (Dijkstra
+ * from every odd vertex), the shortest paths between the pairs are added as repeated edges, and the resulting
+ * Eulerian multigraph is walked with Hierholzer's algorithm.
+ *
+ * Args:
+ *   g (compactGraph): the graph; unweighted graphs count every edge as 1
+ *   start (uint32_t): the first vertex of the walk
+ *   exact_limit (size_t): the largest number of odd vertices that is paired exactly
+ *   budget (searchBudget): the limits of the exact pairing; if it runs out, the pairing is greedy
+ *
+ * Returns:
+ *   The walk. It is only the start vertex if the start has no edges.
+ */
+postmanWalk PostmanWalk(const compactGraph& g, uint32_t start, size_t exact_limit = postman_exact_limit,
+                        const searchBudget& budget = searchBudget());
+
+#endif //GRAPHSOLVER_ROUTEINSPECTION_H
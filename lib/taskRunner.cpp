@@ -0,0 +1,260 @@
+#include "taskRunner.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    std::string JoinNames(const std::vector<std::string>& names) {
+        std::string joined;
+        for (const auto& name : names) {
+            if (!joined.empty()) joined += ' ';
+            joined += name;
+        }
+        return joined;
+    }
+
+    std::string JoinNames(const std::set<std::string>& names) {
+        return JoinNames(std::vector<std::string>(names.begin(), names.end()));
+    }
+}
+
+/**
+ * It copies the graph and builds everything the queries would otherwise build lazily.
+ *
+ * Args:
+ *   g (graphSolver): the graph; later changes to it do not affect the snapshot
+ */
+graphSnapshot::graphSnapshot(const graphSolver& g) : solver(g) {
+    solver.IndexVertices();
+    fingerprint = solver.Fingerprint();
+}
+
+size_t graphSnapshot::FindEccentricity(const std::string& country) const {
+    return solver.FindEccentricity(country);
+}
+
+std::pair<std::string, size_t> graphSnapshot::FindRadius() const {
+    return solver.FindRadius();
+}
+
+std::pair<std::string, size_t> graphSnapshot::FindDiameter() const {
+    return solver.FindDiameter();
+}
+
+std::vector<std::string> graphSnapshot::FindCenter() const {
+    return solver.FindCenter();
+}
+
+searchResult<std::set<std::string>> graphSnapshot::Bronkerbosch(const searchBudget& budget) const {
+    return solver.Bronkerbosch(budget);
+}
+
+searchResult<std::set<std::string>> graphSnapshot::FindMaximumStableSet(const searchBudget& budget) const {
+    return solver.FindMaximumStableSet(budget);
+}
+
+searchResult<matching> graphSnapshot::FindMaximumMatching(const searchBudget& budget) const {
+    return solver.FindMaximumMatching(budget);
+}
+
+spanningTree graphSnapshot::FindMinimumSpanningTree(const weightedAdjacency& distances) const {
+    return solver.FindMinimumSpanningTree(distances);
+}
+
+std::pair<std::string, size_t> graphSnapshot::FindCentroid(spanningTree T) const {
+    return solver.FindCentroid(T);
+}
+
+std::string graphSnapshot::PruferCode(spanningTree T) const {
+    return solver.PruferCode(T);
+}
+
+void analysisReport::Print(std::ostream& out) const {
+    for (const auto& [task, result] : results) {
+        out << task << " : " << result.text << '\n';
+    }
+}
+
+taskRunner::taskRunner(std::shared_ptr<const graphSnapshot> snapshot, size_t threads)
+    : snapshot(std::move(snapshot)), threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+void taskRunner::Add(analysisTask task) {
+    tasks.push_back(std::move(task));
+}
+
+/**
+ * It runs the tasks on a pool of worker threads in dependency order.
+ *
+ * Every task counts its unfinished dependencies; a task whose count is zero is ready. Workers take ready tasks,
+ * run them without holding the lock, and then release the tasks that were waiting for them.
+ *
+ * Returns:
+ *   The report with the result of every task.
+ */
+analysisReport taskRunner::Run() {
+    std::map<std::string, size_t> index;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        if (!index.emplace(tasks[i].name, i).second) {
+            throw std::invalid_argument("taskRunner: duplicate task \"" + tasks[i].name + "\"");
+        }
+    }
+
+    std::vector<size_t> waiting_for(tasks.size(), 0);
+    std::vector<std::vector<size_t>> dependents(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        for (const auto& dependency : tasks[i].dependencies) {
+            auto it = index.find(dependency);
+            if (it == index.end()) {
+                throw std::invalid_argument("taskRunner: task \"" + tasks[i].name + "\" depends on unknown task \"" +
+                                            dependency + "\"");
+            }
+            dependents[it->second].push_back(i);
+            waiting_for[i]++;
+        }
+    }
+
+    /* Checking for cycles with Kahn's algorithm before starting any thread. */
+    {
+        std::vector<size_t> remaining = waiting_for;
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (remaining[i] == 0) ready.push_back(i);
+        }
+        for (size_t head = 0; head < ready.size(); head++) {
+            for (size_t next : dependents[ready[head]]) {
+                if (--remaining[next] == 0) ready.push_back(next);
+            }
+        }
+        if (ready.size() != tasks.size()) throw std::invalid_argument("taskRunner: the dependencies form a cycle");
+    }
+
+    analysisReport report;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<size_t> ready;
+    size_t finished = 0;
+    std::exception_ptr failure;
+
+    /* Every task has its entry from the start, so storing a result never changes the shape of the map while other
+    tasks read the results of their dependencies. */
+    for (size_t i = 0; i < tasks.size(); i++) {
+        report.results[tasks[i].name];
+        if (waiting_for[i] == 0) ready.push_back(i);
+    }
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            changed.wait(guard, [&] { return !ready.empty() || finished == tasks.size() || failure; });
+            if (finished == tasks.size() || failure) return;
+
+            size_t task = ready.back();
+            ready.pop_back();
+
+            /* The task only reads the results of its dependencies, which are finished and no longer change. */
+            guard.unlock();
+            taskResult result;
+            std::exception_ptr error;
+            try {
+                result = tasks[task].run(*snapshot, report);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            guard.lock();
+
+            if (error) {
+                if (!failure) failure = error;
+                changed.notify_all();
+                return;
+            }
+
+            report.results.at(tasks[task].name) = std::move(result);
+            finished++;
+
+            for (size_t next : dependents[task]) {
+                if (--waiting_for[next] == 0) ready.push_back(next);
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < std::min(threads, tasks.size()); i++) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (failure) std::rethrow_exception(failure);
+
+    return report;
+}
+
+/**
+ * It creates the tasks of the homework report. The spanning tree is computed once and shared by the centroid and
+ * Prufer code tasks through the report.
+ *
+ * Args:
+ *   distances (weightedAdjacency): the edge weights for the spanning tree, copied into the task
+ *
+ * Returns:
+ *   The tasks, ready to be added to a taskRunner.
+ */
+std::vector<analysisTask> StandardTasks(const weightedAdjacency& distances) {
+    std::vector<analysisTask> tasks;
+
+    tasks.push_back({"radius", {}, [](const graphSnapshot& g, const analysisReport&) {
+        auto radius = g.FindRadius();
+        return taskResult{radius, radius.first + " " + std::to_string(radius.second)};
+    }});
+
+    tasks.push_back({"diameter", {}, [](const graphSnapshot& g, const analysisReport&) {
+        auto diameter = g.FindDiameter();
+        return taskResult{diameter, diameter.first + " " + std::to_string(diameter.second)};
+    }});
+
+    tasks.push_back({"center", {}, [](const graphSnapshot& g, const analysisReport&) {
+        auto center = g.FindCenter();
+        return taskResult{center, JoinNames(center)};
+    }});
+
+    tasks.push_back({"clique", {}, [](const graphSnapshot& g, const analysisReport&) {
+        auto clique = g.Bronkerbosch();
+        return taskResult{clique.best, JoinNames(clique.best)};
+    }});
+
+    tasks.push_back({"stable set", {}, [](const graphSnapshot& g, const analysisReport&) {
+        auto stable_set = g.FindMaximumStableSet();
+        return taskResult{stable_set.best, JoinNames(stable_set.best)};
+    }});
+
+    tasks.push_back({"matching", {}, [](const graphSnapshot& g, const analysisReport&) {
+        auto max_matching = g.FindMaximumMatching();
+        std::string text = std::to_string(max_matching.best.size()) + " :";
+        for (const auto& [from, to] : max_matching.best) text += " " + from + "-" + to;
+        return taskResult{max_matching.best, text};
+    }});
+
+    tasks.push_back({"spanning tree", {}, [distances](const graphSnapshot& g, const analysisReport&) {
+        spanningTree tree = g.FindMinimumSpanningTree(distances);
+        size_t length = 0;
+        for (const auto& [connected, cost] : tree) length += cost;
+        return taskResult{tree, std::to_string(tree.size()) + " edges, length " + std::to_string(length)};
+    }});
+
+    tasks.push_back({"centroid", {"spanning tree"}, [](const graphSnapshot& g, const analysisReport& report) {
+        auto centroid = g.FindCentroid(report.Get<spanningTree>("spanning tree"));
+        return taskResult{centroid, centroid.first + " " + std::to_string(centroid.second)};
+    }});
+
+    tasks.push_back({"prufer code", {"spanning tree"}, [](const graphSnapshot& g, const analysisReport& report) {
+        std::string prufer_code = g.PruferCode(report.Get<spanningTree>("spanning tree"));
+        return taskResult{prufer_code, prufer_code};
+    }});
+
+    return tasks;
+}
@@ -0,0 +1,99 @@
+#ifndef GRAPHSOLVER_TASKRUNNER_H
+#define GRAPHSOLVER_TASKRUNNER_H
+
+#include <any>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "graphSolver.h"
+
+//This is a read-only copy of a graph that several threads can query at the same time. The id index and the
+//fingerprint are built once in the constructor, the neighbour lookups never insert, and the result cache is
+//synchronized, so none of the queries below writes shared state.
+class graphSnapshot {
+public:
+    explicit graphSnapshot(const graphSolver& g);
+
+    size_t size() const { return solver.name_of.size(); }
+
+    uint64_t Fingerprint() const { return fingerprint; }
+
+    size_t FindEccentricity(const std::string& country) const;
+
+    std::pair<std::string, size_t> FindRadius() const;
+
+    std::pair<std::string, size_t> FindDiameter() const;
+
+    std::vector<std::string> FindCenter() const;
+
+    searchResult<std::set<std::string>> Bronkerbosch(const searchBudget& budget = {}) const;
+
+    searchResult<std::set<std::string>> FindMaximumStableSet(const searchBudget& budget = {}) const;
+
+    searchResult<matching> FindMaximumMatching(const searchBudget& budget = {}) const;
+
+    spanningTree FindMinimumSpanningTree(const weightedAdjacency& distances) const;
+
+    std::pair<std::string, size_t> FindCentroid(spanningTree T) const;
+
+    std::string PruferCode(spanningTree T) const;
+
+private:
+    //Only the query methods above touch it, and none of them changes the graph or the index.
+    mutable graphSolver solver;
+    uint64_t fingerprint;
+};
+
+//The outcome of one task: a value for the tasks that depend on it, and a line of text for the report.
+struct taskResult {
+    std::any value;
+    std::string text;
+};
+
+//The results of all tasks by task name.
+class analysisReport {
+public:
+    std::map<std::string, taskResult> results;
+
+    template <typename T>
+    const T& Get(const std::string& task) const {
+        return std::any_cast<const T&>(results.at(task).value);
+    }
+
+    void Print(std::ostream& out) const;
+};
+
+//An analysis over the snapshot that may use the results of the tasks it depends on.
+struct analysisTask {
+    std::string name;
+    std::vector<std::string> dependencies;
+    std::function<taskResult(const graphSnapshot&, const analysisReport&)> run;
+};
+
+//Runs independent analyses of one snapshot on several threads. A task starts as soon as all its dependencies have
+//finished, so the report takes about as long as the longest dependency chain instead of the sum of all tasks.
+class taskRunner {
+public:
+    explicit taskRunner(std::shared_ptr<const graphSnapshot> snapshot, size_t threads = 0);
+
+    void Add(analysisTask task);
+
+    //Runs all tasks. Throws std::invalid_argument for unknown dependencies or cycles, and rethrows the first
+    //exception thrown by a task.
+    analysisReport Run();
+
+private:
+    std::shared_ptr<const graphSnapshot> snapshot;
+    size_t threads;
+    std::vector<analysisTask> tasks;
+};
+
+//The analyses of the homework: radius, diameter, center, maximum clique, maximum stable set, maximum matching,
+//and the minimum spanning tree followed by its centroid and its Prufer code.
+std::vector<analysisTask> StandardTasks(const weightedAdjacency& distances);
+
+#endif //GRAPHSOLVER_TASKRUNNER_H
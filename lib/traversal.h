@@ -0,0 +1,327 @@
+#ifndef GRAPHSOLVER_TRAVERSAL_H
+#define GRAPHSOLVER_TRAVERSAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//The direction switch of the BFS below (Beamer, Asanovic and Patterson): it turns bottom-up when the frontier has more
+//than 1/alpha of the unexplored arcs, and top-down again when the frontier has less than 1/beta of the vertices.
+constexpr size_t bfs_alpha = 14;
+constexpr size_t bfs_beta = 24;
+
+//A BFS step is split over threads only if it scans at least this many arcs (top-down) or vertices (bottom-up).
+constexpr size_t bfs_parallel_grain = size_t(1) << 16;
+
+//A read-only view of id adjacency lists (as built by graphSolver::IndexVertices) with the basicGraph read interface,
+//so the kernel below also runs on them.
+struct adjacencyListView {
+    using id_type = size_t;
+    static constexpr bool directed = false;
+
+    const std::vector<std::vector<size_t>>& lists;
+
+    size_t size() const { return lists.size(); }
+
+    const std::vector<size_t>& Neighbours(size_t v) const { return lists[v]; }
+};
+
+//The worker threads of one BFS run. They are started once and sleep between levels, so a level split over them costs
+//a wake-up instead of a thread start.
+class levelPool {
+public:
+    explicit levelPool(size_t workers);
+
+    levelPool(const levelPool&) = delete;
+    levelPool& operator=(const levelPool&) = delete;
+
+    ~levelPool();
+
+    //Runs job(i) for every i in [0, parts), part 0 on the calling thread, and returns when all parts are done.
+    //parts must not exceed the workers plus one.
+    void Run(size_t parts, const std::function<void(size_t)>& job);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t parts = 0;
+    size_t pending = 0;
+    size_t generation = 0;
+    bool stop = false;
+};
+
+inline levelPool::levelPool(size_t count) {
+    for (size_t i = 1; i <= count; i++) {
+        workers.emplace_back([this, i]() {
+            size_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                if (i >= parts) continue;
+
+                lock.unlock();
+                (*job)(i);
+                lock.lock();
+                if (--pending == 0) finished.notify_one();
+            }
+        });
+    }
+}
+
+inline levelPool::~levelPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+inline void levelPool::Run(size_t count, const std::function<void(size_t)>& work) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &work;
+        parts = count;
+        pending = count - 1;
+        generation++;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return pending == 0; });
+}
+
+//A breadth-first search that can be run from many sources without reallocating, for any graph with the basicGraph
+//read interface (size(), Neighbours(v), id_type, directed). On undirected graphs it is direction-optimizing: a level
+//is expanded top-down from the frontier while the frontier is small, and bottom-up, where every unvisited vertex
+//looks for a parent in a frontier bitmap, while it is large, which skips most arcs of low-diameter graphs. Large
+//levels are split over the threads given to the constructor, which a run starts at its first large level and keeps until
+//it returns.
+template <typename Graph>
+class bfsKernel {
+public:
+    using Id = typename Graph::id_type;
+
+    static constexpr uint32_t unreached = std::numeric_limits<uint32_t>::max();
+
+    //threads: the threads a large level is split over, 0 for one per hardware thread. The kernel keeps a reference to
+    //the graph, so the graph (or view) must outlive it; temporaries are rejected.
+    explicit bfsKernel(const Graph& g, size_t threads = 1);
+
+    bfsKernel(const Graph&& g, size_t threads = 1) = delete;
+
+    //Runs a BFS from `source` and returns the number of vertices it reached.
+    size_t Run(Id source);
+
+    //The hop distance from the last source, unreached for vertices of other components.
+    uint32_t Distance(Id v) const { return dist[v]; }
+
+    //The vertices reached by the last run by increasing distance; the order within a level may differ between runs
+    //on several threads.
+    const std::vector<Id>& Reached() const { return order; }
+
+    //The largest distance of the last run, the eccentricity of the source in its component.
+    uint32_t Depth() const { return order.empty() ? 0 : dist[order.back()]; }
+
+    //The number of levels of the last run that were expanded bottom-up.
+    size_t BottomUpLevels() const { return bottom_up_levels; }
+
+private:
+    const Graph& g;
+    size_t threads;
+    size_t words;
+    size_t total_arcs = 0;
+    size_t bottom_up_levels = 0;
+
+    std::vector<uint32_t> dist;
+    std::vector<Id> order;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited;
+    std::vector<uint64_t> frontier;
+    size_t frontier_begin = 0;      //the vertices of order[frontier_begin, frontier_end) are set in `frontier`
+    size_t frontier_end = 0;
+    std::unique_ptr<levelPool> pool;   //the workers of the current run, started by its first split level
+
+    //Claims v for the current level; true if no other thread had claimed it.
+    bool Claim(Id v, bool shared) {
+        uint64_t bit = uint64_t(1) << (v % 64);
+        auto& word = visited[v / 64];
+        if (word.load(std::memory_order_relaxed) & bit) return false;
+        if (shared) return !(word.fetch_or(bit, std::memory_order_relaxed) & bit);
+        word.store(word.load(std::memory_order_relaxed) | bit, std::memory_order_relaxed);
+        return true;
+    }
+
+    //Runs work(next) on `parts` threads of the pool, each with its own output list, and appends the lists to `order`.
+    template <typename Work>
+    void Split(size_t parts, const Work& work);
+
+    void TopDown(size_t begin, size_t end, size_t arcs, uint32_t level);
+
+    void BottomUp(uint32_t level);
+
+    void SetFrontier(size_t begin, size_t end);
+};
+
+template <typename Graph>
+bfsKernel<Graph>::bfsKernel(const Graph& g, size_t threads)
+        : g(g),
+          threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+          words((g.size() + 63) / 64),
+          dist(g.size(), unreached),
+          visited(new std::atomic<uint64_t>[(g.size() + 63) / 64]),
+          frontier((g.size() + 63) / 64, 0) {
+    for (size_t w = 0; w < words; w++) visited[w].store(0, std::memory_order_relaxed);
+    for (size_t v = 0; v < g.size(); v++) total_arcs += g.Neighbours(static_cast<Id>(v)).size();
+    order.reserve(g.size());
+}
+
+template <typename Graph>
+template <typename Work>
+void bfsKernel<Graph>::Split(size_t parts, const Work& work) {
+    std::vector<std::vector<Id>> next(parts);
+    if (parts == 1) {
+        work(next[0]);
+    } else {
+        if (!pool) pool = std::make_unique<levelPool>(threads - 1);
+        pool->Run(parts, [&work, &next](size_t i) { work(next[i]); });
+    }
+
+    for (const auto& part : next) order.insert(order.end(), part.begin(), part.end());
+}
+
+/**
+ * It expands order[begin, end) by scanning their arcs. On several threads the frontier is handed out in chunks, and
+ * a vertex belongs to the thread that sets its visited bit first.
+ */
+template <typename Graph>
+void bfsKernel<Graph>::TopDown(size_t begin, size_t end, size_t arcs, uint32_t level) {
+    size_t parts = std::min(threads, std::max<size_t>(1, arcs / bfs_parallel_grain));
+
+    std::atomic<size_t> next_chunk{begin};
+    const size_t chunk = 1024;
+    bool shared = parts > 1;
+
+    Split(parts, [&](std::vector<Id>& next) {
+        for (size_t first = next_chunk.fetch_add(chunk); first < end; first = next_chunk.fetch_add(chunk)) {
+            for (size_t i = first; i < std::min(end, first + chunk); i++) {
+                for (Id to : g.Neighbours(order[i])) {
+                    if (!Claim(to, shared)) continue;
+                    dist[to] = level + 1;
+                    next.push_back(to);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * It finds a parent in the frontier bitmap for every unvisited vertex, stopping at the first one. Every thread takes
+ * whole 64-vertex words, so it owns the visited bits and the distances it writes.
+ */
+template <typename Graph>
+void bfsKernel<Graph>::BottomUp(uint32_t level) {
+    size_t parts = std::min(threads, std::max<size_t>(1, g.size() / bfs_parallel_grain));
+
+    std::atomic<size_t> next_chunk{0};
+    const size_t chunk = 64;
+
+    Split(parts, [&](std::vector<Id>& next) {
+        for (size_t first = next_chunk.fetch_add(chunk); first < words; first = next_chunk.fetch_add(chunk)) {
+            for (size_t w = first; w < std::min(words, first + chunk); w++) {
+                uint64_t unvisited = ~visited[w].load(std::memory_order_relaxed);
+                if (w == words - 1 && g.size() % 64) unvisited &= (uint64_t(1) << (g.size() % 64)) - 1;
+
+                uint64_t found = 0;
+                for (; unvisited; unvisited &= unvisited - 1) {
+                    Id v = static_cast<Id>(w * 64 + __builtin_ctzll(unvisited));
+                    for (Id from : g.Neighbours(v)) {
+                        if (!(frontier[from / 64] >> (from % 64) & 1)) continue;
+                        found |= uint64_t(1) << (v % 64);
+                        dist[v] = level + 1;
+                        next.push_back(v);
+                        break;
+                    }
+                }
+                if (found) visited[w].fetch_or(found, std::memory_order_relaxed);
+            }
+        }
+    });
+}
+
+template <typename Graph>
+void bfsKernel<Graph>::SetFrontier(size_t begin, size_t end) {
+    for (size_t i = frontier_begin; i < frontier_end; i++) frontier[order[i] / 64] = 0;
+    for (size_t i = begin; i < end; i++) frontier[order[i] / 64] |= uint64_t(1) << (order[i] % 64);
+    frontier_begin = begin;
+    frontier_end = end;
+}
+
+/**
+ * It expands the levels one by one, choosing the direction of every level from the size of the frontier. Only the
+ * vertices the previous run reached are reset, so runs from many sources in a small component stay cheap. The
+ * worker threads are started at most once per run and stopped when it returns.
+ *
+ * Args:
+ *   source (Id): the vertex to start from
+ *
+ * Returns:
+ *   The number of vertices reached, the source included.
+ */
+template <typename Graph>
+size_t bfsKernel<Graph>::Run(Id source) {
+    for (Id v : order) {
+        dist[v] = unreached;
+        visited[v / 64].store(0, std::memory_order_relaxed);
+    }
+    SetFrontier(0, 0);
+    order.clear();
+    bottom_up_levels = 0;
+
+    dist[source] = 0;
+    Claim(source, false);
+    order.push_back(source);
+
+    size_t unexplored_arcs = total_arcs;
+    bool bottom_up = false;
+    size_t begin = 0;
+    for (uint32_t level = 0; begin < order.size(); level++) {
+        size_t end = order.size();
+
+        size_t frontier_arcs = 0;
+        for (size_t i = begin; i < end; i++) frontier_arcs += g.Neighbours(order[i]).size();
+        unexplored_arcs -= std::min(unexplored_arcs, frontier_arcs);
+
+        if constexpr (!Graph::directed) {
+            if (!bottom_up && frontier_arcs > unexplored_arcs / bfs_alpha) bottom_up = true;
+            else if (bottom_up && (end - begin) < g.size() / bfs_beta) bottom_up = false;
+        }
+
+        if (bottom_up) {
+            SetFrontier(begin, end);
+            BottomUp(level);
+            bottom_up_levels++;
+        } else {
+            TopDown(begin, end, frontier_arcs, level);
+        }
+        begin = end;
+    }
+    pool.reset();
+
+    return order.size();
+}
+
+#endif //GRAPHSOLVER_TRAVERSAL_H
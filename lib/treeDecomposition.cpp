@@ -0,0 +1,207 @@
+#include "treeDecomposition.h"
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    //The number of edges that eliminating v would add between its remaining neighbours.
+    size_t Fill(const std::vector<std::set<size_t>>& remaining, size_t v) {
+        size_t fill = 0;
+        const auto& around = remaining[v];
+        for (auto a = around.begin(); a != around.end(); ++a) {
+            for (auto b = std::next(a); b != around.end(); ++b) {
+                if (!remaining[*a].count(*b)) fill++;
+            }
+        }
+        return fill;
+    }
+}
+
+treeDecomposition EliminationDecomposition(const std::vector<std::vector<size_t>>& adjacency,
+                                           eliminationHeuristic heuristic, size_t width_limit) {
+    size_t n = adjacency.size();
+
+    treeDecomposition decomposition;
+    decomposition.bags.assign(n, {});
+    decomposition.parent.assign(n, treeDecomposition::npos);
+
+    std::vector<std::set<size_t>> remaining(n);
+    for (size_t u = 0; u < n; u++) {
+        for (size_t v : adjacency[u]) {
+            if (u == v) continue;
+            remaining[u].insert(v);
+            remaining[v].insert(u);
+        }
+    }
+
+    /* A vertex with too many neighbours ends the elimination whenever it is chosen, so its fill is not counted. */
+    auto score = [&](size_t v) {
+        if (heuristic == eliminationHeuristic::min_degree) return remaining[v].size();
+        return remaining[v].size() > width_limit ? SIZE_MAX : Fill(remaining, v);
+    };
+
+    std::vector<size_t> current(n);
+    std::set<std::pair<size_t, size_t>> queue;
+    for (size_t v = 0; v < n; v++) {
+        current[v] = score(v);
+        queue.insert({current[v], v});
+    }
+
+    std::vector<size_t> mark(n, treeDecomposition::npos);
+    while (!queue.empty()) {
+        size_t v = queue.begin()->second;
+        queue.erase(queue.begin());
+
+        std::vector<size_t> later(remaining[v].begin(), remaining[v].end());
+        if (later.size() > width_limit) {
+            decomposition.width = later.size();
+            return decomposition;
+        }
+
+        decomposition.order.push_back(v);
+        decomposition.width = std::max(decomposition.width, later.size());
+        decomposition.bags[v].push_back(v);
+        decomposition.bags[v].insert(decomposition.bags[v].end(), later.begin(), later.end());
+
+        /* The later neighbours become a clique, and v leaves the graph. */
+        std::vector<std::pair<size_t, size_t>> added;
+        for (size_t a : later) {
+            remaining[a].erase(v);
+            for (size_t b : later) {
+                if (a != b && remaining[a].insert(b).second && a < b) added.push_back({a, b});
+            }
+        }
+        remaining[v].clear();
+
+        /* The degree changes only for the later neighbours. The fill also changes for every common neighbour of an
+        added edge, which is looked up from the end with fewer neighbours. */
+        std::vector<size_t> stale;
+        auto touch = [&](size_t u) {
+            if (mark[u] != v) stale.push_back(u);
+            mark[u] = v;
+        };
+        for (size_t a : later) touch(a);
+        if (heuristic == eliminationHeuristic::min_fill) {
+            for (auto [a, b] : added) {
+                if (remaining[a].size() > remaining[b].size()) std::swap(a, b);
+                for (size_t u : remaining[a]) {
+                    if (remaining[b].count(u)) touch(u);
+                }
+            }
+        }
+
+        for (size_t u : stale) {
+            queue.erase({current[u], u});
+            current[u] = score(u);
+            queue.insert({current[u], u});
+        }
+    }
+
+    std::vector<size_t> position(n);
+    for (size_t i = 0; i < n; i++) position[decomposition.order[i]] = i;
+
+    for (size_t v = 0; v < n; v++) {
+        auto& bag = decomposition.bags[v];
+        std::sort(bag.begin() + 1, bag.end(), [&position](size_t lhs, size_t rhs) {
+            return position[lhs] < position[rhs];
+        });
+        if (bag.size() > 1) decomposition.parent[v] = bag[1];
+    }
+
+    return decomposition;
+}
+
+std::vector<size_t> StableSetByDecomposition(const std::vector<std::vector<size_t>>& adjacency,
+                                             const treeDecomposition& decomposition) {
+    if (!decomposition.Complete() || decomposition.bags.size() != adjacency.size()) {
+        throw std::invalid_argument("StableSetByDecomposition: the decomposition does not cover the graph");
+    }
+    if (decomposition.width > 30) {
+        throw std::length_error("StableSetByDecomposition: the decomposition is too wide");
+    }
+
+    size_t n = adjacency.size();
+    std::vector<std::vector<size_t>> children(n);
+    for (size_t v : decomposition.order) {
+        if (decomposition.parent[v] != treeDecomposition::npos) children[decomposition.parent[v]].push_back(v);
+    }
+
+    /* table[v][S]: the largest stable set among v and the vertices below it, given that S is the set taken from the
+    later vertices of its bag (bit i stands for bags[v][i + 1]). A table is dropped once its parent has used it. */
+    std::vector<std::vector<uint32_t>> table(n);
+    std::vector<std::vector<bool>> take(n);
+
+    for (size_t v : decomposition.order) {
+        const auto& bag = decomposition.bags[v];
+        size_t k = bag.size() - 1;
+
+        /* sum[T]: what the children contribute when the bag is taken as T, where bit k stands for v itself. */
+        std::vector<uint32_t> sum(size_t(1) << (k + 1), 0);
+        for (size_t child : children[v]) {
+            const auto& child_bag = decomposition.bags[child];
+
+            std::vector<size_t> bit(child_bag.size() - 1);
+            for (size_t j = 0; j < bit.size(); j++) {
+                bit[j] = child_bag[j + 1] == v ? k : std::find(bag.begin() + 1, bag.end(), child_bag[j + 1]) -
+                                                     bag.begin() - 1;
+            }
+
+            for (size_t T = 0; T < sum.size(); T++) {
+                size_t S = 0;
+                for (size_t j = 0; j < bit.size(); j++) S |= (T >> bit[j] & 1) << j;
+                sum[T] += table[child][S];
+            }
+            std::vector<uint32_t>().swap(table[child]);
+        }
+
+        /* v can only be taken if none of its real neighbours in the bag is; the fill edges do not count. */
+        size_t neighbours = 0;
+        for (size_t i = 0; i < k; i++) {
+            if (std::binary_search(adjacency[v].begin(), adjacency[v].end(), bag[i + 1])) neighbours |= size_t(1) << i;
+        }
+
+        table[v].assign(size_t(1) << k, 0);
+        take[v].assign(size_t(1) << k, false);
+        for (size_t S = 0; S < table[v].size(); S++) {
+            table[v][S] = sum[S];
+            if (S & neighbours) continue;
+
+            uint32_t with = sum[S | size_t(1) << k] + 1;
+            if (with > sum[S]) {
+                table[v][S] = with;
+                take[v][S] = true;
+            }
+        }
+    }
+
+    /* The parents decide first; every bag then reads its own choice for what its later vertices took. */
+    std::vector<bool> taken(n, false);
+    for (auto it = decomposition.order.rbegin(); it != decomposition.order.rend(); ++it) {
+        const auto& bag = decomposition.bags[*it];
+        size_t S = 0;
+        for (size_t i = 1; i < bag.size(); i++) {
+            if (taken[bag[i]]) S |= size_t(1) << (i - 1);
+        }
+        taken[*it] = take[*it][S];
+    }
+
+    std::vector<size_t> stable_set;
+    for (size_t v = 0; v < n; v++) {
+        if (taken[v]) stable_set.push_back(v);
+    }
+    return stable_set;
+}
+
+std::vector<size_t> VertexCoverByDecomposition(const std::vector<std::vector<size_t>>& adjacency,
+                                               const treeDecomposition& decomposition) {
+    std::vector<bool> stable(adjacency.size(), false);
+    for (size_t v : StableSetByDecomposition(adjacency, decomposition)) stable[v] = true;
+
+    std::vector<size_t> cover;
+    for (size_t v = 0; v < adjacency.size(); v++) {
+        if (!stable[v]) cover.push_back(v);
+    }
+    return cover;
+}
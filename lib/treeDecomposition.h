@@ -0,0 +1,68 @@
+#ifndef GRAPHSOLVER_TREEDECOMPOSITION_H
+#define GRAPHSOLVER_TREEDECOMPOSITION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//graphSolver uses the dynamic programs below up to this width, where a bag table has 2^20 entries.
+constexpr size_t decomposition_width_limit = 20;
+
+//Which vertex an elimination ordering removes next.
+enum class eliminationHeuristic {
+    min_degree,     //the vertex with the fewest remaining neighbours
+    min_fill        //the vertex whose elimination adds the fewest edges
+};
+
+//A tree decomposition built from an elimination ordering. There is one bag per vertex v: v and its neighbours that
+//are eliminated after it, in the graph with the fill edges added. The bag of v hangs below the bag of the first of
+//those neighbours to be eliminated, so every bag is a descendant of the bags of its other vertices, and the bags of a
+//connected component form one tree.
+struct treeDecomposition {
+    static constexpr size_t npos = SIZE_MAX;
+
+    std::vector<size_t> order;                  //the elimination order; children come before their parents
+    std::vector<std::vector<size_t>> bags;      //bags[v][0] is v, then the later neighbours in elimination order
+    std::vector<size_t> parent;                 //the parent bag, npos for the root of a component
+    size_t width = 0;                           //the largest bag size minus one
+
+    //False if the elimination stopped because a bag grew beyond the width limit.
+    bool Complete() const { return order.size() == bags.size(); }
+};
+
+/**
+ * It eliminates the vertices one by one with the given heuristic, making the remaining neighbours of every eliminated
+ * vertex a clique, and records the bags. Ties go to the smallest id.
+ *
+ * Args:
+ *   adjacency (vector<vector<size_t>>): id adjacency lists, as built by graphSolver::IndexVertices
+ *   heuristic (eliminationHeuristic): how the next vertex is chosen
+ *   width_limit (size_t): the elimination stops as soon as a bag would be wider than this
+ *
+ * Returns:
+ *   The decomposition. If it stopped early, width is larger than width_limit and Complete() is false.
+ */
+treeDecomposition EliminationDecomposition(const std::vector<std::vector<size_t>>& adjacency,
+                                           eliminationHeuristic heuristic = eliminationHeuristic::min_fill,
+                                           size_t width_limit = SIZE_MAX);
+
+/**
+ * It finds a maximum stable set by dynamic programming over a tree decomposition, in O(n * 2^width * width) time.
+ * The table of a bag holds, for every subset of its later vertices, the largest stable set below the bag that agrees
+ * with that subset; one bit per entry records whether the bag's own vertex was taken, to rebuild the set top-down.
+ *
+ * Args:
+ *   adjacency (vector<vector<size_t>>): id adjacency lists
+ *   decomposition (treeDecomposition): a complete decomposition of the same graph, of width at most 30
+ *
+ * Returns:
+ *   The vertex ids of the set, in increasing order.
+ */
+std::vector<size_t> StableSetByDecomposition(const std::vector<std::vector<size_t>>& adjacency,
+                                             const treeDecomposition& decomposition);
+
+//The vertices outside a maximum stable set found by StableSetByDecomposition.
+std::vector<size_t> VertexCoverByDecomposition(const std::vector<std::vector<size_t>>& adjacency,
+                                               const treeDecomposition& decomposition);
+
+#endif //GRAPHSOLVER_TREEDECOMPOSITION_H
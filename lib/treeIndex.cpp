@@ -0,0 +1,248 @@
+#include "treeIndex.h"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+
+namespace {
+    using weightedNeighbours = std::vector<std::vector<std::pair<uint32_t, size_t>>>;
+
+    uint32_t Root(std::vector<uint32_t>& dsu, uint32_t v) {
+        while (dsu[v] != v) v = dsu[v] = dsu[dsu[v]];
+        return v;
+    }
+
+    //The floor of log2(x), for x > 0.
+    size_t Log2(size_t x) {
+        return 63 - __builtin_clzll(x);
+    }
+}
+
+/**
+ * It roots every tree of the forest at its smallest id and builds the three indexes with iterative walks, so deep
+ * trees do not overflow the stack: the Euler tour with its sparse table (O(n log n) memory), the binary lifting
+ * tables (O(n log depth)), and the centroid decomposition (O(n)).
+ *
+ * Args:
+ *   tree (spanningTree): the edges and their weights, as returned by FindMinimumSpanningTree
+ */
+treeIndex::treeIndex(const spanningTree& tree) {
+    std::set<std::string> countries;
+    for (const auto& [edge, weight] : tree) {
+        countries.insert(edge.first);
+        countries.insert(edge.second);
+    }
+    name_of.assign(countries.begin(), countries.end());
+    for (uint32_t v = 0; v < name_of.size(); v++) index_of[name_of[v]] = v;
+
+    size_t n = size();
+    weightedNeighbours neighbours(n);
+    std::vector<uint32_t> dsu(n);
+    std::iota(dsu.begin(), dsu.end(), 0);
+
+    for (const auto& [edge, weight] : tree) {
+        uint32_t a = index_of[edge.first];
+        uint32_t b = index_of[edge.second];
+
+        uint32_t root_a = Root(dsu, a);
+        uint32_t root_b = Root(dsu, b);
+        if (root_a == root_b) {
+            throw std::invalid_argument("treeIndex: the edge " + edge.first + " - " + edge.second + " closes a cycle");
+        }
+        dsu[root_a] = root_b;
+
+        neighbours[a].push_back({b, weight});
+        neighbours[b].push_back({a, weight});
+    }
+
+    tree_of.assign(n, npos);
+    depth.assign(n, 0);
+    weight_to_root.assign(n, 0);
+    first_visit.assign(n, 0);
+    up.assign(1, std::vector<uint32_t>(n));
+    heaviest.assign(1, std::vector<size_t>(n, 0));
+
+    /* Depth-first from every root, keeping the index of the next neighbour to visit for every vertex on the path. */
+    std::vector<uint32_t> tour;
+    std::vector<std::pair<uint32_t, size_t>> path;
+    uint32_t max_depth = 0;
+    for (uint32_t root = 0; root < n; root++) {
+        if (tree_of[root] != npos) continue;
+
+        tree_of[root] = root;
+        up[0][root] = root;
+        first_visit[root] = tour.size();
+        tour.push_back(root);
+        path.assign(1, {root, 0});
+
+        while (!path.empty()) {
+            auto& [v, next] = path.back();
+            if (next == neighbours[v].size()) {
+                path.pop_back();
+                if (!path.empty()) tour.push_back(path.back().first);
+                continue;
+            }
+
+            auto [to, weight] = neighbours[v][next++];
+            if (tree_of[to] != npos) continue;
+
+            tree_of[to] = root;
+            depth[to] = depth[v] + 1;
+            weight_to_root[to] = weight_to_root[v] + weight;
+            up[0][to] = v;
+            heaviest[0][to] = weight;
+            max_depth = std::max(max_depth, depth[to]);
+
+            first_visit[to] = tour.size();
+            tour.push_back(to);
+            path.push_back({to, 0});
+        }
+    }
+
+    shallowest.assign(1, std::move(tour));
+    for (size_t k = 1; (size_t(1) << k) <= shallowest[0].size(); k++) {
+        const auto& below = shallowest[k - 1];
+        size_t half = size_t(1) << (k - 1);
+
+        std::vector<uint32_t> level(below.size() - half);
+        for (size_t i = 0; i < level.size(); i++) level[i] = Shallower(below[i], below[i + half]);
+        shallowest.push_back(std::move(level));
+    }
+
+    for (size_t k = 1; (uint32_t(1) << k) <= max_depth; k++) {
+        std::vector<uint32_t> level(n);
+        std::vector<size_t> level_heaviest(n);
+        for (uint32_t v = 0; v < n; v++) {
+            uint32_t middle = up[k - 1][v];
+            level[v] = up[k - 1][middle];
+            level_heaviest[v] = std::max(heaviest[k - 1][v], heaviest[k - 1][middle]);
+        }
+        up.push_back(std::move(level));
+        heaviest.push_back(std::move(level_heaviest));
+    }
+
+    std::vector<std::vector<uint32_t>> plain(n);
+    for (uint32_t v = 0; v < n; v++) {
+        for (auto [to, weight] : neighbours[v]) plain[v].push_back(to);
+    }
+    BuildCentroids(plain);
+}
+
+/**
+ * It splits every tree at its centroid, the vertex whose removal leaves parts of at most half the size, and the parts
+ * recursively, so every vertex has O(log n) centroid ancestors. The parts are kept on an explicit stack.
+ */
+void treeIndex::BuildCentroids(const std::vector<std::vector<uint32_t>>& neighbours) {
+    size_t n = size();
+    centroid_parent.assign(n, npos);
+    nearest.assign(n, {unreachable, npos});
+
+    std::vector<bool> removed(n, false);
+    std::vector<uint32_t> part;
+    std::vector<uint32_t> parent(n);
+    std::vector<size_t> part_size(n);
+
+    /* Every part is given by one of its vertices and the centroid it hangs below. */
+    std::vector<std::pair<uint32_t, uint32_t>> parts;
+    for (uint32_t v = 0; v < n; v++) {
+        if (tree_of[v] == v) parts.push_back({v, npos});
+    }
+
+    while (!parts.empty()) {
+        auto [start, above] = parts.back();
+        parts.pop_back();
+
+        part.assign(1, start);
+        parent[start] = npos;
+        for (size_t head = 0; head < part.size(); head++) {
+            uint32_t v = part[head];
+            for (uint32_t to : neighbours[v]) {
+                if (removed[to] || to == parent[v]) continue;
+                parent[to] = v;
+                part.push_back(to);
+            }
+        }
+
+        for (uint32_t v : part) part_size[v] = 1;
+        for (size_t i = part.size(); i-- > 1;) part_size[parent[part[i]]] += part_size[part[i]];
+
+        uint32_t centroid = start;
+        for (uint32_t v : part) {
+            size_t largest = part.size() - part_size[v];
+            for (uint32_t to : neighbours[v]) {
+                if (!removed[to] && to != parent[v]) largest = std::max(largest, part_size[to]);
+            }
+            if (2 * largest <= part.size()) {
+                centroid = v;
+                break;
+            }
+        }
+
+        centroid_parent[centroid] = above;
+        removed[centroid] = true;
+        for (uint32_t to : neighbours[centroid]) {
+            if (!removed[to]) parts.push_back({to, centroid});
+        }
+    }
+}
+
+uint32_t treeIndex::Lca(uint32_t a, uint32_t b) const {
+    if (tree_of[a] != tree_of[b]) return npos;
+
+    size_t left = std::min(first_visit[a], first_visit[b]);
+    size_t right = std::max(first_visit[a], first_visit[b]);
+    size_t k = Log2(right - left + 1);
+    return Shallower(shallowest[k][left], shallowest[k][right + 1 - (size_t(1) << k)]);
+}
+
+size_t treeIndex::PathWeight(uint32_t a, uint32_t b) const {
+    uint32_t lca = Lca(a, b);
+    if (lca == npos) return unreachable;
+    return weight_to_root[a] + weight_to_root[b] - 2 * weight_to_root[lca];
+}
+
+size_t treeIndex::HeaviestEdge(uint32_t a, uint32_t b) const {
+    uint32_t lca = Lca(a, b);
+    if (lca == npos) return unreachable;
+
+    size_t result = 0;
+    for (uint32_t v : {a, b}) {
+        uint32_t climb = depth[v] - depth[lca];
+        for (size_t k = 0; climb; k++, climb >>= 1) {
+            if (!(climb & 1)) continue;
+            result = std::max(result, heaviest[k][v]);
+            v = up[k][v];
+        }
+    }
+    return result;
+}
+
+/**
+ * It records v at each of its centroid ancestors whose nearest marked vertex is farther away. A path from a vertex u
+ * passes the lowest common centroid ancestor c of u and v, so NearestMarked(u) only has to look at the centroid
+ * ancestors of u.
+ */
+void treeIndex::Mark(uint32_t v) {
+    for (uint32_t c = v; c != npos; c = centroid_parent[c]) {
+        std::pair<size_t, uint32_t> candidate{PathWeight(v, c), v};
+        if (candidate >= nearest[c]) continue;
+
+        if (nearest[c].second == npos) touched.push_back(c);
+        nearest[c] = candidate;
+    }
+}
+
+void treeIndex::ClearMarks() {
+    for (uint32_t c : touched) nearest[c] = {unreachable, npos};
+    touched.clear();
+}
+
+std::pair<uint32_t, size_t> treeIndex::NearestMarked(uint32_t v) const {
+    std::pair<size_t, uint32_t> best{unreachable, npos};
+    for (uint32_t c = v; c != npos; c = centroid_parent[c]) {
+        if (nearest[c].second == npos) continue;
+        best = std::min(best, {nearest[c].first + PathWeight(v, c), nearest[c].second});
+    }
+    return {best.second, best.first};
+}
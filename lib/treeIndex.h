@@ -0,0 +1,81 @@
+#ifndef GRAPHSOLVER_TREEINDEX_H
+#define GRAPHSOLVER_TREEINDEX_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using spanningTree = std::vector<std::pair<std::pair<std::string, std::string>, size_t>>;
+
+//Path queries on a weighted forest, such as a minimum spanning tree: the lowest common ancestor and the path weight
+//in O(1), the heaviest edge on a path (the bottleneck) and the nearest marked vertex in O(log n). The vertices get
+//ids in lexicographic order of their names.
+class treeIndex {
+public:
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t unreachable = std::numeric_limits<size_t>::max();
+
+    std::vector<std::string> name_of;
+    std::unordered_map<std::string, uint32_t> index_of;
+
+    //Throws std::invalid_argument if the edges contain a cycle.
+    explicit treeIndex(const spanningTree& tree);
+
+    size_t size() const { return name_of.size(); }
+
+    //The lowest common ancestor when every tree is rooted at its smallest id, npos for vertices of different trees.
+    uint32_t Lca(uint32_t a, uint32_t b) const;
+
+    //The total weight of the path, unreachable for vertices of different trees.
+    size_t PathWeight(uint32_t a, uint32_t b) const;
+
+    //The heaviest edge weight on the path: the largest weight that a path between a and b must cross in any
+    //spanning tree, if this is a minimum one. It is 0 for a == b and unreachable for vertices of different trees.
+    size_t HeaviestEdge(uint32_t a, uint32_t b) const;
+
+    void Mark(uint32_t v);
+
+    void ClearMarks();
+
+    //The marked vertex with the lightest path from v and that path weight; {npos, unreachable} if no marked vertex
+    //is in the tree of v.
+    std::pair<uint32_t, size_t> NearestMarked(uint32_t v) const;
+
+    //The same queries by name; they throw std::out_of_range for an unknown country.
+    size_t PathWeight(const std::string& a, const std::string& b) const {
+        return PathWeight(index_of.at(a), index_of.at(b));
+    }
+
+    size_t HeaviestEdge(const std::string& a, const std::string& b) const {
+        return HeaviestEdge(index_of.at(a), index_of.at(b));
+    }
+
+    void Mark(const std::string& v) { Mark(index_of.at(v)); }
+
+private:
+    std::vector<uint32_t> tree_of;          //the root of the tree of every vertex
+    std::vector<uint32_t> depth;            //in edges
+    std::vector<size_t> weight_to_root;
+
+    //The Euler tour and a sparse table of its shallowest vertex over every power-of-two range.
+    std::vector<uint32_t> first_visit;
+    std::vector<std::vector<uint32_t>> shallowest;
+
+    //up[k][v] is the ancestor 2^k edges above v (or the root), heaviest[k][v] the heaviest edge on the way there.
+    std::vector<std::vector<uint32_t>> up;
+    std::vector<std::vector<size_t>> heaviest;
+
+    //The parent of every vertex in the centroid decomposition, and the nearest marked vertex below every centroid.
+    std::vector<uint32_t> centroid_parent;
+    std::vector<std::pair<size_t, uint32_t>> nearest;
+    std::vector<uint32_t> touched;
+
+    uint32_t Shallower(uint32_t a, uint32_t b) const { return depth[a] <= depth[b] ? a : b; }
+
+    void BuildCentroids(const std::vector<std::vector<uint32_t>>& neighbours);
+};
+
+#endif //GRAPHSOLVER_TREEINDEX_H
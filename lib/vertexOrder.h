@@ -0,0 +1,167 @@
+#ifndef GRAPHSOLVER_VERTEXORDER_H
+#define GRAPHSOLVER_VERTEXORDER_H
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+//How the vertices are numbered. Neighbouring vertices with close ids share cache lines in every per-vertex array,
+//which makes traversals (BFS, eccentricity) and neighbour intersections touch less memory.
+enum class vertexOrder {
+    lexicographic,          //by name, the default
+    degree,                 //by decreasing degree, so the hubs are packed together
+    bfs,                    //in BFS order from the smallest id of every component
+    reverseCuthillMcKee     //reverse Cuthill-McKee, which keeps the ids of neighbours close (small bandwidth)
+};
+
+/**
+ * It computes a vertex order for a graph given by its size and a neighbour function.
+ *
+ * Args:
+ *   n (size_t): the number of vertices
+ *   neighbours (Neighbours): neighbours(v) returns an iterable range of the neighbours of v
+ *   kind (vertexOrder): the order to compute
+ *
+ * Returns:
+ *   The old ids in their new order, so order[new_id] == old_id.
+ */
+template <typename Neighbours>
+std::vector<size_t> ComputeVertexOrder(size_t n, const Neighbours& neighbours, vertexOrder kind) {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (kind == vertexOrder::lexicographic) return order;
+
+    std::vector<size_t> degree(n);
+    for (size_t v = 0; v < n; v++) {
+        degree[v] = neighbours(v).size();
+    }
+
+    if (kind == vertexOrder::degree) {
+        std::stable_sort(order.begin(), order.end(), [&degree](size_t lhs, size_t rhs) {
+            return degree[lhs] > degree[rhs];
+        });
+        return order;
+    }
+
+    std::vector<bool> visited(n, false);
+    std::vector<size_t> sorted_neighbours;
+
+    /* A BFS that appends the component of `start` to `out`; Cuthill-McKee visits the neighbours by increasing degree. */
+    auto bfs = [&](size_t start, std::vector<size_t>& out, bool by_degree) {
+        size_t head = out.size();
+        visited[start] = true;
+        out.push_back(start);
+
+        for (; head < out.size(); head++) {
+            sorted_neighbours.clear();
+            for (auto to : neighbours(out[head])) {
+                if (!visited[to]) sorted_neighbours.push_back(to);
+            }
+
+            if (by_degree) {
+                std::sort(sorted_neighbours.begin(), sorted_neighbours.end(), [&degree](size_t lhs, size_t rhs) {
+                    return degree[lhs] != degree[rhs] ? degree[lhs] < degree[rhs] : lhs < rhs;
+                });
+            }
+
+            for (size_t to : sorted_neighbours) {
+                if (visited[to]) continue;
+                visited[to] = true;
+                out.push_back(to);
+            }
+        }
+    };
+
+    std::vector<size_t> result;
+    result.reserve(n);
+
+    if (kind == vertexOrder::bfs) {
+        for (size_t v = 0; v < n; v++) {
+            if (!visited[v]) bfs(v, result, false);
+        }
+        return result;
+    }
+
+    /* Reverse Cuthill-McKee, started in every component from a pseudo-peripheral vertex: the minimum degree vertex of
+    the last BFS level, seen from the minimum degree vertex of the component. */
+    const size_t unreached = static_cast<size_t>(-1);
+    std::vector<size_t> component;
+    std::vector<size_t> level(n, unreached);
+
+    for (size_t v = 0; v < n; v++) {
+        if (visited[v]) continue;
+
+        component.clear();
+        bfs(v, component, false);
+
+        size_t start = *std::min_element(component.begin(), component.end(), [&degree](size_t lhs, size_t rhs) {
+            return degree[lhs] < degree[rhs];
+        });
+
+        /* `component` is in BFS order from v, but the levels are needed from `start`. */
+        std::vector<size_t> queue(1, start);
+        level[start] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (auto to : neighbours(queue[head])) {
+                if (level[to] != unreached) continue;
+                level[to] = level[queue[head]] + 1;
+                queue.push_back(to);
+            }
+        }
+
+        size_t last_level = level[queue.back()];
+        for (size_t u : queue) {
+            if (level[u] == last_level && degree[u] < degree[start]) start = u;
+        }
+
+        for (size_t u : component) visited[u] = false;
+        bfs(start, result, true);
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * It renumbers a basicGraph so that order[new_id] == old_id. The names move with their vertices, so the results of
+ * the renumbered graph are still reported by name.
+ *
+ * Returns:
+ *   The renumbered graph.
+ */
+template <typename Graph>
+Graph Reorder(const Graph& g, const std::vector<size_t>& order) {
+    using Id = typename Graph::id_type;
+
+    std::vector<Id> new_id(g.size());
+    std::vector<std::string> names(g.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        new_id[order[i]] = static_cast<Id>(i);
+        names[i] = g.name_of[order[i]];
+    }
+
+    std::vector<typename Graph::edge> edges;
+    edges.reserve(g.ArcCount());
+    for (size_t v = 0; v < g.size(); v++) {
+        for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+            /* Build adds the reverse arc of undirected edges itself. */
+            if (!Graph::directed && g.targets[arc] < v) continue;
+            edges.push_back({new_id[v], new_id[g.targets[arc]], g.WeightOf(arc)});
+        }
+    }
+
+    return Graph::Build(std::move(names), edges, g.Weighted());
+}
+
+/**
+ * It renumbers a basicGraph by one of the standard vertex orders.
+ */
+template <typename Graph>
+Graph Reorder(const Graph& g, vertexOrder kind) {
+    return Reorder(g, ComputeVertexOrder(g.size(), [&g](size_t v) {
+        return g.Neighbours(static_cast<typename Graph::id_type>(v));
+    }, kind));
+}
+
+#endif //GRAPHSOLVER_VERTEXORDER_H
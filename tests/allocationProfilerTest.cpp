@@ -0,0 +1,115 @@
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <malloc.h>
+
+#include "lib/allocationProfiler.h"
+
+namespace {
+    //The blocks live outside the functions, so the compiler cannot drop a new and delete pair.
+    char* blocks[8];
+
+    //The usable size of a block of 100 bytes, which every allocation below has.
+    size_t block_bytes = 0;
+
+    void Allocate(size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            blocks[i] = new char[100];
+            std::memset(blocks[i], int(i), 100);
+            block_bytes = malloc_usable_size(blocks[i]);
+        }
+    }
+
+    void Free(size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) delete[] blocks[i];
+    }
+
+    //Four blocks, two of them freed, then one more: five allocations and four blocks at the peak.
+    void Flat() {
+        allocationScope scope("flat");
+        Allocate(0, 4);
+        Free(0, 2);
+        Allocate(0, 1);
+        Free(0, 1);
+        Free(2, 4);
+    }
+
+    //One block kept across an inner call that holds two: the outer peak is three blocks, the inner one two.
+    void Nested() {
+        allocationScope scope("outer");
+        Allocate(0, 1);
+        {
+            allocationScope inner("inner");
+            Allocate(1, 3);
+            Free(1, 3);
+        }
+        Free(0, 1);
+    }
+
+    void Macro() {
+        PROFILE_ALLOCATIONS("macro");
+        Allocate(0, 1);
+        Free(0, 1);
+    }
+
+    bool Expect(const std::string& method, size_t calls, size_t allocations, size_t peak_blocks) {
+        auto profile = AllocationProfile();
+        auto it = profile.find(method);
+        allocationStats stats = it == profile.end() ? allocationStats() : it->second;
+        if (!AllocationProfilingEnabled()) allocations = peak_blocks = 0;
+
+        if (stats.calls == calls && stats.allocations == allocations &&
+            stats.bytes_allocated == allocations * block_bytes && stats.peak_live_bytes == peak_blocks * block_bytes) {
+            return true;
+        }
+        std::cerr << method << ": " << stats.calls << " calls, " << stats.allocations << " allocations, "
+                  << stats.bytes_allocated << " bytes, peak " << stats.peak_live_bytes << "; expected " << calls
+                  << " calls, " << allocations << " allocations of " << block_bytes << " bytes, peak of "
+                  << peak_blocks << " blocks\n";
+        return false;
+    }
+}
+
+/* Scopes must count exactly the allocations of their own thread, the bytes as malloc_usable_size gives them, and the
+peak above what was live when they opened; nested scopes charge the outer method too, and repeated calls keep the
+largest peak. Built against the library as configured, the counts are zero unless profiling is on, and the
+PROFILE_ALLOCATIONS macro records nothing without it; the profiled copy of this test always checks the counts. */
+int main() {
+    int failures = 0;
+
+    Flat();
+    Nested();
+    Nested();
+    Macro();
+
+    std::thread worker([] {
+        allocationScope scope("worker");
+        Allocate(4, 5);
+        Free(4, 5);
+    });
+    worker.join();
+
+    failures += !Expect("flat", 1, 5, 4);
+    failures += !Expect("outer", 2, 6, 3);
+    failures += !Expect("inner", 2, 4, 2);
+    failures += !Expect("worker", 1, 1, 1);
+    failures += !Expect("macro", AllocationProfilingEnabled() ? 1 : 0, 1, 1);
+
+    std::ostringstream summary;
+    PrintAllocationSummary(summary);
+    if ((summary.str().find("outer") != std::string::npos) != AllocationProfilingEnabled()) {
+        std::cerr << "the summary does not match the build:\n" << summary.str();
+        failures++;
+    }
+
+    ResetAllocationProfile();
+    if (!AllocationProfile().empty()) {
+        std::cerr << "the profile is not empty after a reset\n";
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
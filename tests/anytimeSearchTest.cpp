@@ -0,0 +1,42 @@
+#include <iostream>
+#include <vector>
+
+#include "lib/anytimeSearch.h"
+
+namespace {
+    //k disjoint cliques of `size` vertices each.
+    std::vector<std::vector<size_t>> DisjointCliques(size_t k, size_t size) {
+        std::vector<std::vector<size_t>> adjacency(k * size);
+        for (size_t c = 0; c < k; c++) {
+            for (size_t u = c * size; u < (c + 1) * size; u++) {
+                for (size_t v = c * size; v < (c + 1) * size; v++) {
+                    if (u != v) adjacency[u].push_back(v);
+                }
+            }
+        }
+        return adjacency;
+    }
+}
+
+/* The Tutte-Berge bound with U empty counts one odd component per clique, so the greedy matching of disjoint odd
+cliques is proven optimal at the root, also on graphs too large for the single-vertex passes. */
+int main() {
+    int failures = 0;
+
+    searchBudget budget;
+    budget.node_limit = 1;
+
+    for (size_t size : {3, 5}) {
+        for (size_t k : {1, 3, 10, 2000}) {
+            auto result = MaximumMatchingSearch(DisjointCliques(k, size), budget);
+            size_t expected = k * (size / 2);
+            if (result.best.size() != expected || result.upper_bound != expected || !result.optimal) {
+                std::cerr << k << " cliques of " << size << ": matching " << result.best.size() << ", upper bound "
+                          << result.upper_bound << ", expected " << expected << '\n';
+                failures++;
+            }
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lib/basicGraph.h"
+
+namespace {
+    template <typename Graph>
+    using arcMap = std::map<std::pair<size_t, size_t>, typename Graph::weight_type>;
+
+    //The labels of the (weakly) connected components, numbered in order of their smallest vertex.
+    std::vector<size_t> Components(size_t n, const std::vector<std::pair<size_t, size_t>>& pairs) {
+        std::vector<std::vector<size_t>> adjacency(n);
+        for (auto [a, b] : pairs) {
+            adjacency[a].push_back(b);
+            adjacency[b].push_back(a);
+        }
+
+        std::vector<size_t> label(n, SIZE_MAX);
+        size_t components = 0;
+        for (size_t v = 0; v < n; v++) {
+            if (label[v] != SIZE_MAX) continue;
+            std::vector<size_t> stack{v};
+            label[v] = components;
+            while (!stack.empty()) {
+                size_t u = stack.back();
+                stack.pop_back();
+                for (size_t to : adjacency[u]) {
+                    if (label[to] == SIZE_MAX) label[to] = components, stack.push_back(to);
+                }
+            }
+            components++;
+        }
+        return label;
+    }
+
+    //The largest hop count from the source along the arcs.
+    template <typename Graph>
+    size_t NaiveEccentricity(size_t n, const arcMap<Graph>& arcs, size_t source) {
+        std::vector<size_t> dist(n, SIZE_MAX);
+        std::vector<size_t> queue{source};
+        dist[source] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            size_t v = queue[head];
+            for (auto it = arcs.lower_bound({v, 0}); it != arcs.end() && it->first.first == v; ++it) {
+                if (dist[it->first.second] != SIZE_MAX) continue;
+                dist[it->first.second] = dist[v] + 1;
+                queue.push_back(it->first.second);
+            }
+        }
+        return dist[queue.back()];
+    }
+
+    //The weight of a minimum spanning forest by Prim's algorithm from every unvisited vertex, on the lightest arcs.
+    template <typename Graph>
+    double PrimWeight(size_t n, const arcMap<Graph>& arcs) {
+        std::vector<bool> in_tree(n, false);
+        double total = 0;
+        for (size_t root = 0; root < n; root++) {
+            if (in_tree[root]) continue;
+            std::vector<double> best(n, -1);
+            best[root] = 0;
+            while (true) {
+                size_t next = SIZE_MAX;
+                for (size_t v = 0; v < n; v++) {
+                    if (!in_tree[v] && best[v] >= 0 && (next == SIZE_MAX || best[v] < best[next])) next = v;
+                }
+                if (next == SIZE_MAX) break;
+                in_tree[next] = true;
+                total += best[next];
+                for (auto it = arcs.lower_bound({next, 0}); it != arcs.end() && it->first.first == next; ++it) {
+                    double w = it->second;
+                    size_t to = it->first.second;
+                    if (!in_tree[to] && (best[to] < 0 || w < best[to])) best[to] = w;
+                }
+            }
+        }
+        return total;
+    }
+
+    //Builds random graphs with self-loops and parallel edges of different weights, and compares the CSR arrays,
+    //the components, the eccentricities and (for undirected graphs) the spanning forest with naive versions.
+    template <typename Graph>
+    int Check(const char* name, std::mt19937& rng) {
+        using Id = typename Graph::id_type;
+        using Weight = typename Graph::weight_type;
+        int failures = 0;
+
+        for (size_t round = 0; round < 30; round++) {
+            size_t n = 1 + rng() % 60;
+            bool weighted = round % 3 != 0;
+
+            std::vector<std::string> names;
+            for (size_t v = 0; v < n; v++) names.push_back("v" + std::to_string(v));
+
+            std::vector<typename Graph::edge> edges;
+            std::vector<std::pair<size_t, size_t>> pairs;
+            arcMap<Graph> arcs;
+            for (size_t i = rng() % (3 * n); i > 0; i--) {
+                Id a = static_cast<Id>(rng() % n), b = static_cast<Id>(rng() % n);
+                Weight w = static_cast<Weight>(1 + rng() % 20);
+                if (!weighted) w = 1;
+                edges.push_back({a, b, w});
+                if (rng() % 3 == 0) edges.push_back({a, b, static_cast<Weight>(w + (weighted ? 5 : 0))});
+                if (a == b) continue;
+
+                pairs.emplace_back(a, b);
+                for (auto arc : {std::pair<size_t, size_t>{a, b}, std::pair<size_t, size_t>{b, a}}) {
+                    if (Graph::directed && arc.first == b && arc.second == a) continue;
+                    auto it = arcs.find(arc);
+                    if (it == arcs.end() || w < it->second) arcs[arc] = w;
+                }
+            }
+
+            Graph g = Graph::Build(names, edges, weighted);
+
+            bool rows = g.offsets.size() == n + 1 && g.ArcCount() == arcs.size();
+            size_t arc = 0;
+            for (auto [ends, w] : arcs) {
+                if (!rows) break;
+                rows = g.offsets[ends.first] <= arc && arc < g.offsets[ends.first + 1] &&
+                       g.targets[arc] == ends.second && g.WeightOf(arc) == (weighted ? w : Weight(1));
+                arc++;
+            }
+
+            auto expected = Components(n, pairs);
+            auto found = ConnectedComponents(g);
+            bool components = std::equal(found.begin(), found.end(), expected.begin(), expected.end(),
+                                         [](Id lhs, size_t rhs) { return lhs == rhs; });
+
+            bool eccentricities = true;
+            for (size_t v = 0; v < n && eccentricities; v++) {
+                eccentricities = Eccentricity(g, static_cast<Id>(v)) == NaiveEccentricity<Graph>(n, arcs, v);
+            }
+
+            bool forest = true;
+            if constexpr (!Graph::directed) {
+                double weight = 0;
+                for (const auto& e : MinimumSpanningForest(g)) weight += e.weight;
+                forest = weight == PrimWeight<Graph>(n, arcs);
+            }
+
+            if (!rows || !components || !eccentricities || !forest) {
+                std::cerr << name << ", graph of " << n << " vertices:" << (rows ? "" : " wrong rows")
+                          << (components ? "" : " wrong components") << (eccentricities ? "" : " wrong eccentricities")
+                          << (forest ? "" : " wrong spanning forest") << '\n';
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+}
+
+/* basicGraph::Build must drop self-loops and keep the lightest of parallel edges in sorted rows, and the components,
+eccentricities and spanning forests must match naive versions, for every id width, weight type and direction. */
+int main() {
+    std::mt19937 rng(1);
+    int failures = 0;
+
+    failures += Check<compactGraph>("compactGraph", rng);
+    failures += Check<basicGraph<uint16_t, uint32_t, false>>("16-bit ids", rng);
+    failures += Check<basicGraph<uint32_t, double, false>>("double weights", rng);
+    failures += Check<basicGraph<uint16_t, float, true>>("directed, float weights", rng);
+
+    bool too_many = false;
+    try {
+        basicGraph<uint16_t>::Build(std::vector<std::string>(65535), {}, false);
+    } catch (const std::length_error&) {
+        too_many = true;
+    }
+    if (!too_many) {
+        std::cerr << "65535 vertices were accepted with 16-bit ids\n";
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
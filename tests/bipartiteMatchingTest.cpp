@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "lib/graphSolver.h"
+
+namespace {
+    //The size of a maximum matching: the first free vertex is either left out or matched to a free neighbour.
+    size_t BruteForceMatching(const std::vector<std::vector<size_t>>& adjacency, std::vector<bool>& used, size_t from) {
+        while (from < adjacency.size() && used[from]) from++;
+        if (from == adjacency.size()) return 0;
+
+        used[from] = true;
+        size_t best = BruteForceMatching(adjacency, used, from + 1);
+        for (size_t to : adjacency[from]) {
+            if (used[to]) continue;
+            used[to] = true;
+            best = std::max(best, 1 + BruteForceMatching(adjacency, used, from + 1));
+            used[to] = false;
+        }
+        used[from] = false;
+        return best;
+    }
+
+    std::string Name(size_t v) { return "v" + std::to_string(v); }
+
+    //Whether the pairs are edges and no vertex is in two of them.
+    bool ValidMatching(const std::set<std::pair<std::string, std::string>>& edges, const matching& pairs) {
+        std::set<std::string> matched;
+        for (const auto& [a, b] : pairs) {
+            if (!edges.count({a, b}) || !matched.insert(a).second || !matched.insert(b).second) return false;
+        }
+        return true;
+    }
+}
+
+/* FindBipartiteMatching must recognise bipartite graphs and return a maximum matching (Hopcroft-Karp) together with a
+vertex cover of the same size (Konig); FindMaximumMatching must also find the maximum on graphs that are not
+bipartite. Both are checked against an exhaustive search on random graphs of up to 16 vertices. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 200; round++) {
+        size_t n = 1 + rng() % 16;
+        bool bipartite = round % 2 == 0;
+        unsigned density = 10 + rng() % 60;
+
+        /* Bipartite graphs only get edges between vertices of different sides, the side being a random bit. */
+        std::vector<int> side(n);
+        for (auto& s : side) s = rng() % 2;
+
+        graphSolver g;
+        std::vector<std::vector<size_t>> adjacency(n);
+        std::set<std::pair<std::string, std::string>> edges;
+        for (size_t v = 0; v < n; v++) g.Edit([v](adjacencyMap& graph, weightMap&) { graph[Name(v)]; });
+        for (size_t u = 0; u < n; u++) {
+            for (size_t v = u + 1; v < n; v++) {
+                if ((bipartite && side[u] == side[v]) || rng() % 100 >= density) continue;
+                g.addEdge(Name(u), Name(v));
+                adjacency[u].push_back(v);
+                adjacency[v].push_back(u);
+                edges.insert({Name(u), Name(v)});
+                edges.insert({Name(v), Name(u)});
+            }
+        }
+
+        std::vector<bool> used(n, false);
+        size_t expected = BruteForceMatching(adjacency, used, 0);
+
+        matching pairs;
+        std::set<std::string> cover;
+        bool found_bipartite = g.FindBipartiteMatching(pairs, cover);
+        if (bipartite) {
+            bool covered = true;
+            for (const auto& [a, b] : edges) covered = covered && (cover.count(a) || cover.count(b));
+            if (!found_bipartite || pairs.size() != expected || !ValidMatching(edges, pairs) ||
+                cover.size() != expected || !covered) {
+                std::cerr << "bipartite graph of " << n << " vertices: matching " << pairs.size() << ", cover "
+                          << cover.size() << ", expected " << expected << '\n';
+                failures++;
+            }
+        }
+
+        auto maximum = g.FindMaximumMatching();
+        if (maximum.size() != expected || !ValidMatching(edges, maximum)) {
+            std::cerr << "graph of " << n << " vertices: FindMaximumMatching found " << maximum.size() << ", expected "
+                      << expected << '\n';
+            failures++;
+        }
+    }
+
+    /* A triangle has no 2-coloring. */
+    graphSolver triangle;
+    triangle.addEdge("a", "b");
+    triangle.addEdge("b", "c");
+    triangle.addEdge("c", "a");
+    matching pairs;
+    std::set<std::string> cover;
+    if (triangle.FindBipartiteMatching(pairs, cover)) {
+        std::cerr << "a triangle was taken for a bipartite graph\n";
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
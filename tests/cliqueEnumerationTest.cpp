@@ -0,0 +1,86 @@
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "lib/graphSolver.h"
+
+namespace {
+    //Every maximal clique with at least `min_size` vertices, by trying every subset, as sets of names.
+    std::set<std::set<std::string>> BruteForceCliques(const std::vector<uint32_t>& rows, size_t min_size) {
+        size_t n = rows.size();
+        std::set<std::set<std::string>> cliques;
+        for (uint32_t subset = 1; subset < (uint32_t(1) << n); subset++) {
+            uint32_t common = (uint32_t(1) << n) - 1;
+            bool clique = true;
+            for (size_t v = 0; v < n; v++) {
+                if (!(subset >> v & 1)) continue;
+                clique = clique && (subset & ~(uint32_t(1) << v) & ~rows[v]) == 0;
+                common &= rows[v];
+            }
+            if (!clique || common || size_t(__builtin_popcount(subset)) < min_size) continue;
+
+            std::set<std::string> names;
+            for (size_t v = 0; v < n; v++) {
+                if (subset >> v & 1) names.insert("v" + std::to_string(v));
+            }
+            cliques.insert(names);
+        }
+        return cliques;
+    }
+}
+
+/* EnumerateMaximalCliques must report every maximal clique exactly once, skip the ones below min_size and stop when
+the callback returns false; checked against all subsets of random graphs of up to 14 vertices. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 100; round++) {
+        size_t n = 1 + rng() % 14;
+        unsigned density = 10 + rng() % 81;
+
+        graphSolver g;
+        std::vector<uint32_t> rows(n, 0);
+        for (size_t v = 0; v < n; v++) {
+            g.Edit([v](adjacencyMap& graph, weightMap&) { graph["v" + std::to_string(v)]; });
+        }
+        for (size_t u = 0; u < n; u++) {
+            for (size_t v = u + 1; v < n; v++) {
+                if (rng() % 100 >= density) continue;
+                g.addEdge("v" + std::to_string(u), "v" + std::to_string(v));
+                rows[u] |= uint32_t(1) << v;
+                rows[v] |= uint32_t(1) << u;
+            }
+        }
+
+        for (size_t min_size : {size_t(1), size_t(3)}) {
+            std::set<std::set<std::string>> found;
+            size_t reported = 0;
+            g.EnumerateMaximalCliques([&](const std::vector<size_t>& clique) {
+                std::set<std::string> names;
+                for (size_t id : clique) names.insert(g.name_of[id]);
+                found.insert(names);
+                reported++;
+                return true;
+            }, min_size);
+
+            auto expected = BruteForceCliques(rows, min_size);
+            if (found != expected || reported != expected.size()) {
+                std::cerr << "graph of " << n << " vertices, min_size " << min_size << ": " << reported
+                          << " cliques reported, " << expected.size() << " expected\n";
+                failures++;
+            }
+        }
+
+        size_t calls = 0;
+        g.EnumerateMaximalCliques([&](const std::vector<size_t>&) { return ++calls < 2; });
+        if (calls != std::min<size_t>(2, BruteForceCliques(rows, 1).size())) {
+            std::cerr << "graph of " << n << " vertices: the enumeration went on after the callback returned false\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/denseGraph.h"
+
+namespace {
+    //The size of a maximum clique by trying every subset, with the rows as bit masks.
+    size_t BruteForceClique(const std::vector<uint32_t>& rows) {
+        size_t n = rows.size();
+        size_t best = 0;
+        for (uint32_t subset = 1; subset < (uint32_t(1) << n); subset++) {
+            size_t size = __builtin_popcount(subset);
+            if (size <= best) continue;
+
+            bool clique = true;
+            for (uint32_t rest = subset; rest && clique; rest &= rest - 1) {
+                size_t v = __builtin_ctz(rest);
+                clique = (subset & ~(uint32_t(1) << v) & ~rows[v]) == 0;
+            }
+            if (clique) best = size;
+        }
+        return best;
+    }
+
+    //Whether every two of the vertices are adjacent (or, for a stable set, none are).
+    bool Clique(const std::vector<std::vector<size_t>>& adjacency, const std::vector<size_t>& vertices, bool adjacent) {
+        for (size_t u : vertices) {
+            for (size_t v : vertices) {
+                if (u == v) continue;
+                bool edge = std::binary_search(adjacency[u].begin(), adjacency[u].end(), v);
+                if (edge != adjacent) return false;
+            }
+        }
+        return true;
+    }
+
+    bool Cover(const std::vector<std::vector<size_t>>& adjacency, const std::vector<size_t>& vertices) {
+        std::vector<bool> in(adjacency.size(), false);
+        for (size_t v : vertices) in[v] = true;
+        for (size_t u = 0; u < adjacency.size(); u++) {
+            for (size_t v : adjacency[u]) {
+                if (!in[u] && !in[v]) return false;
+            }
+        }
+        return true;
+    }
+
+    //The graph with vertex v renumbered to v * spread, with isolated vertices in between, so the rows span words.
+    std::vector<std::vector<size_t>> Spread(const std::vector<std::vector<size_t>>& adjacency, size_t spread) {
+        std::vector<std::vector<size_t>> spread_out(adjacency.size() * spread);
+        for (size_t u = 0; u < adjacency.size(); u++) {
+            for (size_t v : adjacency[u]) spread_out[u * spread].push_back(v * spread);
+        }
+        return spread_out;
+    }
+}
+
+/* The bitset searches must find a maximum clique, a maximum stable set and a minimum vertex cover of the sizes found
+by trying every subset, on random graphs of up to 20 vertices, in the 64-vertex size class and spread over the
+words of larger ones. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 120; round++) {
+        size_t n = 1 + rng() % 20;
+        unsigned density = 10 + rng() % 81;
+
+        std::vector<std::vector<size_t>> adjacency(n);
+        std::vector<uint32_t> rows(n, 0), complement_rows(n, 0);
+        for (size_t u = 0; u < n; u++) {
+            for (size_t v = u + 1; v < n; v++) {
+                if (rng() % 100 < density) {
+                    adjacency[u].push_back(v);
+                    adjacency[v].push_back(u);
+                    rows[u] |= uint32_t(1) << v;
+                    rows[v] |= uint32_t(1) << u;
+                } else {
+                    complement_rows[u] |= uint32_t(1) << v;
+                    complement_rows[v] |= uint32_t(1) << u;
+                }
+            }
+        }
+        for (auto& row : adjacency) std::sort(row.begin(), row.end());
+
+        size_t omega = BruteForceClique(rows);
+        size_t alpha = BruteForceClique(complement_rows);
+
+        denseGraph<64> dense(adjacency);
+        auto clique = dense.MaximumClique();
+        auto stable = dense.MaximumStableSet();
+        auto cover = dense.MinimumVertexCover();
+        if (clique.size() != omega || !Clique(adjacency, clique, true) || stable.size() != alpha ||
+            !Clique(adjacency, stable, false) || cover.size() != n - alpha || !Cover(adjacency, cover)) {
+            std::cerr << "graph of " << n << " vertices: clique " << clique.size() << " (expected " << omega
+                      << "), stable set " << stable.size() << " (expected " << alpha << ")\n";
+            failures++;
+        }
+
+        size_t spread = 1 + round % 25;
+        auto wide = Spread(adjacency, spread);
+        auto wide_clique = WithDenseGraph(wide, [](const auto& g) { return g.MaximumClique(); });
+        if (wide_clique.size() != omega || !Clique(wide, wide_clique, true)) {
+            std::cerr << "graph of " << n << " vertices spread over " << wide.size() << ": clique "
+                      << wide_clique.size() << " (expected " << omega << ")\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lib/distanceOracle.h"
+
+namespace {
+    compactGraph FromEdges(size_t n, const std::vector<std::pair<uint32_t, uint32_t>>& pairs) {
+        std::vector<std::string> names;
+        for (size_t v = 0; v < n; v++) names.push_back("v" + std::to_string(v));
+
+        std::vector<compactGraph::edge> edges;
+        for (auto [a, b] : pairs) edges.push_back({a, b, 1});
+        return compactGraph::Build(names, edges, false);
+    }
+
+    //A random graph of `components` parts, each a random tree plus a few random edges inside it.
+    compactGraph RandomGraph(size_t n, size_t components, std::mt19937& rng) {
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        for (uint32_t v = 0; v < n; v++) {
+            uint32_t first = v % components;
+            if (v >= components) pairs.emplace_back(first + components * (rng() % (v / components)), v);
+            if (rng() % 4 == 0) {
+                uint32_t other = first + components * (rng() % (n / components));
+                if (other != v && other < n) pairs.emplace_back(v, other);
+            }
+        }
+        return FromEdges(n, pairs);
+    }
+
+    //A path of `length` edges whose middle vertex has id 0, so Build measures its eccentricity, length / 2.
+    compactGraph MiddlePath(size_t length) {
+        std::vector<uint32_t> order;
+        for (uint32_t v = 1; v <= length / 2; v++) order.push_back(v);
+        order.push_back(0);
+        for (uint32_t v = uint32_t(length / 2 + 1); v <= length; v++) order.push_back(v);
+
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        for (size_t i = 0; i + 1 < order.size(); i++) pairs.emplace_back(order[i], order[i + 1]);
+        return FromEdges(length + 1, pairs);
+    }
+
+    std::vector<size_t> Distances(const compactGraph& g, uint32_t source) {
+        std::vector<size_t> dist(g.size(), distanceOracle::unreachable);
+        std::vector<uint32_t> queue{source};
+        dist[source] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (uint32_t to : g.Neighbours(queue[head])) {
+                if (dist[to] != distanceOracle::unreachable) continue;
+                dist[to] = dist[queue[head]] + 1;
+                queue.push_back(to);
+            }
+        }
+        return dist;
+    }
+
+    //The number of pairs on which the oracle disagrees with a plain BFS.
+    size_t WrongPairs(const compactGraph& g, const distanceOracle& oracle) {
+        size_t wrong = 0;
+        for (uint32_t a = 0; a < g.size(); a++) {
+            auto dist = Distances(g, a);
+            for (uint32_t b = 0; b < g.size(); b++) wrong += oracle.Distance(a, b) != dist[b];
+        }
+        return wrong;
+    }
+
+    bool LoadFails(const std::string& path) {
+        try {
+            distanceOracle::Load(path);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+/* distanceOracle must agree with a plain BFS on every pair, with 4-bit cells up to the largest distance they hold,
+with 8-bit cells, across components and after a Save and Load; Load must reject damaged files. landmarkOracle must
+bound every distance from both sides. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 20; round++) {
+        compactGraph g = RandomGraph(3 + rng() % 150, 1 + rng() % 3, rng);
+        distanceOracle oracle = distanceOracle::Build(g, 1 + round % 3);
+        if (size_t wrong = WrongPairs(g, oracle)) {
+            std::cerr << "graph of " << g.size() << " vertices: " << wrong << " wrong distances\n";
+            failures++;
+        }
+
+        landmarkOracle landmarks = landmarkOracle::Build(g, 4, 1);
+        for (uint32_t a = 0; a < g.size(); a++) {
+            auto dist = Distances(g, a);
+            for (uint32_t b = 0; b < g.size(); b++) {
+                if (landmarks.Distance(a, b) < dist[b] || landmarks.LowerBound(a, b) > dist[b]) {
+                    std::cerr << "landmarks do not bound " << a << " - " << b << '\n';
+                    failures++;
+                }
+            }
+        }
+    }
+
+    /* A path of 14 edges from a middle vertex fits 4-bit cells with its ends at 14, one below the missing value. */
+    compactGraph narrow = MiddlePath(14);
+    distanceOracle narrow_oracle = distanceOracle::Build(narrow);
+    if (narrow_oracle.CellBits() != 4 || narrow_oracle.Distance(1, 14) != 14 || WrongPairs(narrow, narrow_oracle)) {
+        std::cerr << "path of 14 edges: " << narrow_oracle.CellBits() << "-bit cells\n";
+        failures++;
+    }
+
+    compactGraph wide = MiddlePath(16);
+    distanceOracle wide_oracle = distanceOracle::Build(wide);
+    if (wide_oracle.CellBits() != 8 || WrongPairs(wide, wide_oracle)) {
+        std::cerr << "path of 16 edges: " << wide_oracle.CellBits() << "-bit cells\n";
+        failures++;
+    }
+
+    bool too_far = false;
+    try {
+        distanceOracle::Build(MiddlePath(255));
+    } catch (const std::length_error&) {
+        too_far = true;
+    }
+    if (!too_far) {
+        std::cerr << "a distance of 255 was accepted\n";
+        failures++;
+    }
+
+    std::string path = "distanceOracleTest.dist";
+    narrow_oracle.Save(path);
+    if (WrongPairs(narrow, distanceOracle::Load(path))) {
+        std::cerr << "the loaded table differs\n";
+        failures++;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    /* The header is the magic, n, the cell bits and the cell bytes, 8 bytes each. */
+    auto rejects = [&](std::string copy) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << copy;
+        return LoadFails(path);
+    };
+    auto patched = [&](size_t offset, uint64_t value) {
+        return bytes.substr(0, offset) + std::string(reinterpret_cast<char*>(&value), sizeof(value)) +
+               bytes.substr(offset + sizeof(value));
+    };
+    if (!rejects(patched(8, uint64_t(1) << 40)) || !rejects(patched(8, 16)) || !rejects(patched(24, 1000)) ||
+        !rejects(bytes.substr(0, bytes.size() - 3)) || !rejects(bytes.substr(0, 20)) || !rejects(bytes + "x")) {
+        std::cerr << "a damaged table was loaded\n";
+        failures++;
+    }
+    std::remove(path.c_str());
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/graphSolver.h"
+#include "lib/traversal.h"
+
+namespace {
+    //The hop distance of every vertex from `source` by a plain queue BFS, SIZE_MAX outside its component.
+    std::vector<size_t> Distances(const std::vector<std::vector<size_t>>& adjacency, size_t source) {
+        std::vector<size_t> dist(adjacency.size(), SIZE_MAX);
+        std::vector<size_t> queue{source};
+        dist[source] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (size_t to : adjacency[queue[head]]) {
+                if (dist[to] != SIZE_MAX) continue;
+                dist[to] = dist[queue[head]] + 1;
+                queue.push_back(to);
+            }
+        }
+        return dist;
+    }
+
+    //The eccentricity of every vertex by a plain queue BFS over the id adjacency lists.
+    std::vector<size_t> Eccentricities(const std::vector<std::vector<size_t>>& adjacency) {
+        std::vector<size_t> eccentricity(adjacency.size());
+        for (size_t source = 0; source < adjacency.size(); source++) {
+            std::vector<size_t> dist(adjacency.size(), SIZE_MAX);
+            std::vector<size_t> queue{source};
+            dist[source] = 0;
+            for (size_t head = 0; head < queue.size(); head++) {
+                for (size_t to : adjacency[queue[head]]) {
+                    if (dist[to] != SIZE_MAX) continue;
+                    dist[to] = dist[queue[head]] + 1;
+                    queue.push_back(to);
+                }
+            }
+            eccentricity[source] = dist[queue.back()];
+        }
+        return eccentricity;
+    }
+}
+
+/* FindEccentricity, FindRadius, FindDiameter and FindCenter run the BFS kernel of traversal.h over the id adjacency
+lists; they must agree with a plain BFS. A kernel on several threads must also agree with it on a graph large enough
+for its levels to be split over the worker pool. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t n : {1, 2, 10, 60, 300}) {
+        graphSolver g;
+        g.use_cache = false;
+        for (size_t v = 0; v < n; v++) {
+            g.Edit([v](adjacencyMap& graph, weightMap&) { graph["v" + std::to_string(v)]; });
+            for (size_t k = 0; k < 2; k++) {
+                size_t to = rng() % n;
+                if (to != v) g.addEdge("v" + std::to_string(v), "v" + std::to_string(to));
+            }
+        }
+
+        g.IndexVertices();
+        auto expected = Eccentricities(g.adjacency);
+        size_t radius = *std::min_element(expected.begin(), expected.end());
+        size_t diameter = *std::max_element(expected.begin(), expected.end());
+
+        size_t wrong = 0;
+        for (size_t v = 0; v < n; v++) wrong += g.FindEccentricity(g.name_of[v]) != expected[v];
+
+        std::vector<std::string> center;
+        for (size_t v = 0; v < n; v++) {
+            if (expected[v] == radius) center.push_back(g.name_of[v]);
+        }
+        auto found_center = g.FindCenter();
+        std::sort(found_center.begin(), found_center.end());
+
+        if (wrong || g.FindRadius().second != radius || g.FindDiameter().second != diameter || found_center != center) {
+            std::cerr << "graph of " << n << " vertices: " << wrong << " wrong eccentricities, radius "
+                      << g.FindRadius().second << " (expected " << radius << "), diameter " << g.FindDiameter().second
+                      << " (expected " << diameter << ")\n";
+            failures++;
+        }
+    }
+
+    const size_t n = 200000;
+    std::vector<std::vector<size_t>> adjacency(n);
+    for (size_t v = 1; v < n; v++) {
+        for (size_t to : {size_t(rng() % v), size_t(rng() % n)}) {
+            if (to == v) continue;
+            adjacency[v].push_back(to);
+            adjacency[to].push_back(v);
+        }
+    }
+
+    adjacencyListView view{adjacency};
+    bfsKernel<adjacencyListView> bfs(view, 4);
+    for (size_t source : {size_t(0), size_t(n / 2), n - 1}) {
+        auto expected = Distances(adjacency, source);
+        bfs.Run(source);
+
+        size_t wrong = 0;
+        for (size_t v = 0; v < n; v++) wrong += bfs.Distance(v) != expected[v];
+        if (wrong || bfs.Reached().size() != n) {
+            std::cerr << "4 threads from " << source << ": " << wrong << " wrong distances, " << bfs.Reached().size()
+                      << " of " << n << " vertices reached\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lib/graphSolver.h"
+
+namespace {
+    struct listing {
+        size_t from;
+        size_t to;
+        size_t weight;
+        size_t line = 0;
+    };
+
+    std::string Name(size_t v) { return (v % 2 ? "North c" : "c") + std::to_string(v); }
+
+    //The problems LoadWeighted must report and the weight it must keep for every edge, found by going through the
+    //listings of every edge in line order. `rank` is the order in which the names first appear in the text.
+    std::vector<std::string> ExpectedProblems(const std::vector<listing>& listings, const std::vector<size_t>& rank,
+                                              std::map<std::pair<size_t, size_t>, size_t>& weights) {
+        std::vector<std::string> problems;
+        std::map<std::pair<size_t, size_t>, std::vector<listing>> by_edge;
+        for (const auto& l : listings) {
+            if (l.from == l.to) {
+                problems.push_back("line " + std::to_string(l.line) + ": self-loop at " + Name(l.from) + " is dropped");
+                continue;
+            }
+            bool earlier = rank[l.from] < rank[l.to];
+            by_edge[{earlier ? l.from : l.to, earlier ? l.to : l.from}].push_back(l);
+        }
+
+        for (const auto& [edge, all] : by_edge) {
+            const listing* forward = nullptr;
+            const listing* backward = nullptr;
+            size_t weight = all.front().weight;
+            for (const auto& l : all) {
+                const listing*& seen = l.from == edge.first ? forward : backward;
+                if (seen) {
+                    problems.push_back("line " + std::to_string(l.line) + ": " + Name(l.from) + " - " + Name(l.to) +
+                                       " is already listed on line " + std::to_string(seen->line));
+                } else {
+                    seen = &l;
+                }
+                weight = std::min(weight, l.weight);
+            }
+            if (forward && backward && forward->weight != backward->weight) {
+                problems.push_back("line " + std::to_string(backward->line) + ": " + Name(edge.second) + " - " +
+                                   Name(edge.first) + " weighs " + std::to_string(backward->weight) + ", but line " +
+                                   std::to_string(forward->line) + " gives " + std::to_string(forward->weight) +
+                                   "; keeping " + std::to_string(weight));
+            }
+            weights[{edge.first, edge.second}] = weight;
+            weights[{edge.second, edge.first}] = weight;
+        }
+
+        std::sort(problems.begin(), problems.end());
+        return problems;
+    }
+
+    //Whether loading the text throws std::runtime_error naming the line.
+    bool Rejects(const std::string& text, size_t line) {
+        graphSolver g;
+        std::istringstream stream(text);
+        try {
+            g.LoadWeighted(stream);
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what()).find("line " + std::to_string(line) + " ") != std::string::npos;
+        }
+        return false;
+    }
+}
+
+/* LoadWeighted must report every duplicate, asymmetric weight and self-loop on the line where it appears, keep the
+lightest weight of every edge, and name the line of a malformed input. The listings of random graphs are written as a
+mix of edge lines, adjacency lines, comments and empty lines, and the report is compared with the one found by going
+through the listings of every edge in line order. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 200; round++) {
+        size_t n = 2 + rng() % 8;
+
+        /* Random edges, some listed again in the same direction, some in the other one, and a few self-loops. */
+        std::vector<listing> pending;
+        for (size_t i = rng() % 20; i > 0; i--) {
+            size_t a = rng() % n, b = rng() % n, w = 1 + rng() % 9;
+            if (a == b && rng() % 3) continue;
+            pending.push_back({a, b, w});
+            if (rng() % 4 == 0) pending.push_back({a, b, rng() % 2 ? w : 1 + rng() % 9});
+            if (rng() % 2) pending.push_back({b, a, rng() % 2 ? w : 1 + rng() % 9});
+        }
+        std::shuffle(pending.begin(), pending.end(), rng);
+
+        /* Writing them out; an adjacency line takes later listings from the same country, never the same target twice
+        so that the order of the listings of an edge is fixed by their lines. */
+        std::string text;
+        std::vector<listing> listings;
+        std::vector<size_t> rank(n, SIZE_MAX);
+        size_t next_rank = 0, line = 0;
+        auto seen = [&](size_t v) {
+            if (rank[v] == SIZE_MAX) rank[v] = next_rank++;
+        };
+        std::vector<bool> written(pending.size(), false);
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (written[i]) continue;
+            if (rng() % 4 == 0) {
+                text += rng() % 2 ? "# a comment\n" : "  \n";
+                line++;
+            }
+
+            line++;
+            listing first = pending[i];
+            written[i] = true;
+            seen(first.from);
+            if (rng() % 2) {
+                seen(first.to);
+                text += Name(first.from) + ", " + Name(first.to) + ", " + std::to_string(first.weight) + '\n';
+                listings.push_back({first.from, first.to, first.weight, line});
+                continue;
+            }
+
+            std::vector<bool> target(n, false);
+            text += Name(first.from) + ":";
+            for (size_t j = i; j < pending.size(); j++) {
+                if (written[j] && j != i) continue;
+                if (pending[j].from != first.from || (j != i && (target[pending[j].to] || rng() % 2))) continue;
+                written[j] = true;
+                target[pending[j].to] = true;
+                seen(pending[j].to);
+                text += (j == i ? " " : ", ") + Name(pending[j].to) + " " + std::to_string(pending[j].weight);
+                listings.push_back({pending[j].from, pending[j].to, pending[j].weight, line});
+            }
+            text += '\n';
+        }
+
+        std::map<std::pair<size_t, size_t>, size_t> weights;
+        auto expected = ExpectedProblems(listings, rank, weights);
+
+        graphSolver g;
+        std::istringstream stream(text);
+        loadReport report = g.LoadWeighted(stream);
+        auto problems = report.problems;
+        std::sort(problems.begin(), problems.end());
+
+        size_t found = 0;
+        bool kept = true;
+        for (const auto& [from, to] : g.AdjacencyLists()) {
+            for (size_t i = 0; i < to.size(); i++) {
+                auto it = weights.find({std::stoul(from.substr(from.find('c') + 1)),
+                                        std::stoul(to[i].substr(to[i].find('c') + 1))});
+                kept = kept && it != weights.end() && g.EdgeWeights().at(from)[i] == it->second;
+                found++;
+            }
+        }
+
+        if (problems != expected || report.lines != line || report.edges * 2 != weights.size() ||
+            found != weights.size() || !kept) {
+            std::cerr << "round " << round << ": " << problems.size() << " problems (expected " << expected.size()
+                      << "), " << report.edges << " edges (expected " << weights.size() / 2 << ")"
+                      << (kept ? "" : ", wrong weights") << '\n';
+            for (const auto& p : problems) std::cerr << "  found:    " << p << '\n';
+            for (const auto& p : expected) std::cerr << "  expected: " << p << '\n';
+            failures++;
+        }
+    }
+
+    /* Malformed lines after two good ones. */
+    const std::string good = "a, b, 3\n# c: d 4\n";
+    for (const std::string bad : {"a, b", "a, b, x", ", b, 3", "a: b", "a: b 3, c", "a: b -1", "a b 3"}) {
+        if (!Rejects(good + bad + "\nb, c, 1\n", 3)) {
+            std::cerr << "\"" << bad << "\" was not rejected as line 3\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lib/mappedGraph.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(bool ok, const std::string& what) {
+        if (ok) return;
+        std::cerr << what << '\n';
+        failures++;
+    }
+
+    std::string ReadFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    }
+
+    void WriteFile(const std::string& path, const std::string& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+    }
+
+    bool Rejected(const std::string& path) {
+        try {
+            mappedGraph g(path);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Weight>
+    Weight ForestWeight(const std::vector<basicEdge<uint32_t, Weight>>& forest) {
+        Weight total = 0;
+        for (const auto& e : forest) total += e.weight;
+        return total;
+    }
+}
+
+/* BuildFromEdgeList must give the same graph as basicGraph::Build on the same edges (parallel edges merged into the
+lightest one, self-loops dropped), the streaming algorithms must agree with the basicGraph templates, and damaged
+files must be rejected when they are opened. */
+int main() {
+    std::mt19937 rng(11);
+    const std::string edge_list = "mappedGraphTest.txt";
+    const std::string file = "mappedGraphTest.csr";
+
+    for (size_t n : {2, 20, 300}) {
+        std::vector<std::string> names(n);
+        for (size_t v = 0; v < n; v++) names[v] = std::to_string(v);
+
+        std::vector<compactGraph::edge> edges;
+        std::ofstream out(edge_list, std::ios::trunc);
+        for (size_t i = 0; i < 3 * n; i++) {
+            uint32_t from = rng() % n;
+            uint32_t to = i == 0 ? n - 1 : rng() % n;
+            size_t weight = 1 + rng() % 9;
+            edges.push_back({from, to, weight});
+            out << from << ' ' << to << ' ' << weight << '\n';
+            if (i % 4 == 0) {
+                edges.push_back({to, from, weight + 1});
+                out << to << ' ' << from << ' ' << weight + 1 << '\n';
+            }
+        }
+        out.close();
+
+        auto expected = compactGraph::Build(names, edges, true);
+        mappedGraph::BuildFromEdgeList(edge_list, file);
+        mappedGraph mapped(file);
+
+        bool same = mapped.size() == expected.size() && mapped.ArcCount() == expected.ArcCount();
+        for (size_t arc = 0; same && arc < expected.ArcCount(); arc++) {
+            same = mapped.targets[arc] == expected.targets[arc] && mapped.WeightOf(arc) == expected.WeightOf(arc);
+        }
+        Check(same, "BuildFromEdgeList differs from basicGraph::Build on " + std::to_string(n) + " vertices");
+
+        for (uint32_t source = 0; source < n; source += 7) {
+            Check(StreamingEccentricity(mapped, source) == Eccentricity(expected, source),
+                  "StreamingEccentricity differs from Eccentricity");
+        }
+        Check(ForestWeight(StreamingMinimumSpanningForest(mapped)) == ForestWeight(MinimumSpanningForest(expected)),
+              "StreamingMinimumSpanningForest is not minimum");
+
+        mappedGraph::Write(expected, file);
+        mappedGraph written(file);
+        Check(written.Name(n - 1) == names[n - 1], "Write lost the names");
+    }
+
+    std::string good = ReadFile(file);
+    Check(Rejected(file + ".missing"), "a missing file was accepted");
+
+    WriteFile(file, good.substr(0, good.size() - 3));
+    Check(Rejected(file), "a file cut inside its names was accepted");
+
+    WriteFile(file, good.substr(0, good.size() / 2));
+    Check(Rejected(file), "a file cut in half was accepted");
+
+    std::string bad_target = good;
+    bad_target[4 * 8 + (300 + 1) * 8] = '\xff';
+    bad_target[4 * 8 + (300 + 1) * 8 + 1] = '\xff';
+    WriteFile(file, bad_target);
+    Check(Rejected(file), "a target out of range was accepted");
+
+    std::string bad_names = good;
+    bad_names[bad_names.size() - 2] = '\n';
+    WriteFile(file, bad_names);
+    Check(Rejected(file), "a name count that differs from the vertex count was accepted");
+
+    std::string huge = good;
+    for (size_t i = 8; i < 16; i++) huge[i] = '\x7f';
+    WriteFile(file, huge);
+    Check(Rejected(file), "a huge vertex count was accepted");
+
+    std::remove(edge_list.c_str());
+    std::remove(file.c_str());
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "lib/packedGraph.h"
+
+namespace {
+    //A random graph with a hub of more than 128 neighbours, so some degrees and gaps take several varint bytes.
+    compactGraph RandomGraph(size_t n, bool weighted, std::mt19937& rng) {
+        std::vector<std::string> names;
+        for (size_t v = 0; v < n; v++) {
+            names.push_back("country " + std::to_string(rng() % 1000) + "/" + std::to_string(v));
+        }
+
+        std::set<std::pair<uint32_t, uint32_t>> pairs;
+        for (uint32_t v = 1; v < n; v++) {
+            if (v % 2) pairs.insert({0, v});
+            for (size_t k = rng() % 4; k > 0; k--) {
+                uint32_t to = rng() % n;
+                if (to != v) pairs.insert({std::min(v, to), std::max(v, to)});
+            }
+        }
+
+        std::vector<compactGraph::edge> edges;
+        for (auto [a, b] : pairs) edges.push_back({a, b, weighted ? 1 + rng() % 100000 : 1});
+        return compactGraph::Build(names, edges, weighted);
+    }
+
+    size_t Weight(const std::vector<compactGraph::edge>& forest) {
+        size_t weight = 0;
+        for (const auto& e : forest) weight += e.weight;
+        return weight;
+    }
+}
+
+/* packedGraph must give back every row of the graph it packed, with the same neighbours, weights and degrees, the
+same names, and the same answers from the basicGraph algorithms. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 20; round++) {
+        bool weighted = round % 2;
+        compactGraph g = RandomGraph(1 + rng() % 600, weighted, rng);
+        packedGraph packed = packedGraph::Build(g);
+
+        size_t wrong_rows = 0, wrong_names = 0;
+        for (uint32_t v = 0; v < g.size(); v++) {
+            auto row = packed.Neighbours(v);
+            size_t arc = g.offsets[v];
+            for (auto it = row.begin(); it != row.end(); ++it, arc++) {
+                if (arc == g.offsets[v + 1] || *it != g.targets[arc] || it.Weight() != g.WeightOf(arc)) break;
+            }
+            wrong_rows += arc != g.offsets[v + 1] || row.size() != g.Neighbours(v).size();
+            wrong_names += packed.Name(v) != g.name_of[v] || packed.IdOf(g.name_of[v]) != v;
+        }
+
+        bool same = packed.size() == g.size() && packed.ArcCount() == g.ArcCount() &&
+                    packed.Weighted() == weighted && packed.IdOf("nowhere") == packedGraph::npos &&
+                    ConnectedComponents(packed) == ConnectedComponents(g) &&
+                    Weight(MinimumSpanningForest(g)) == Weight(MinimumSpanningForest(packed));
+        for (uint32_t v = 0; v < g.size() && same; v += 37) same = Eccentricity(packed, v) == Eccentricity(g, v);
+
+        if (wrong_rows || wrong_names || !same) {
+            std::cerr << "graph of " << g.size() << " vertices: " << wrong_rows << " wrong rows, " << wrong_names
+                      << " wrong names\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lib/graphSolver.h"
+
+namespace {
+    const vertexOrder orders[] = {vertexOrder::lexicographic, vertexOrder::degree, vertexOrder::bfs,
+                                  vertexOrder::reverseCuthillMcKee};
+
+    //The weighted edges by name, which a renumbering must not change.
+    std::map<std::pair<std::string, std::string>, size_t> EdgesByName(const compactGraph& g) {
+        std::map<std::pair<std::string, std::string>, size_t> edges;
+        for (uint32_t v = 0; v < g.size(); v++) {
+            for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+                edges[{g.name_of[v], g.name_of[g.targets[arc]]}] = g.WeightOf(arc);
+            }
+        }
+        return edges;
+    }
+
+    //The largest id difference of an edge.
+    size_t Bandwidth(const compactGraph& g) {
+        size_t bandwidth = 0;
+        for (uint32_t v = 0; v < g.size(); v++) {
+            for (uint32_t to : g.Neighbours(v)) bandwidth = std::max<size_t>(bandwidth, to > v ? to - v : v - to);
+        }
+        return bandwidth;
+    }
+}
+
+/* Every vertex order must be a permutation, a renumbered graph must keep its edges by name, and graphSolver must give
+the same answers after Reorder as before. Reverse Cuthill-McKee must turn a path with shuffled ids into one of
+bandwidth 1. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 40; round++) {
+        size_t n = 1 + rng() % 40;
+
+        /* A few components and isolated vertices: every vertex links to an earlier one with probability 3/4. */
+        std::vector<std::string> names;
+        std::vector<compactGraph::edge> edges;
+        for (uint32_t v = 0; v < n; v++) {
+            names.push_back("c" + std::to_string(rng() % 1000) + "_" + std::to_string(v));
+            if (v && rng() % 4) edges.push_back({uint32_t(rng() % v), v, 1 + rng() % 50});
+            if (v && rng() % 3 == 0) edges.push_back({uint32_t(rng() % v), v, 1 + rng() % 50});
+        }
+        compactGraph g = compactGraph::Build(names, edges, true);
+
+        graphSolver solver;
+        for (const auto& name : names) solver.Edit([&name](adjacencyMap& graph, weightMap&) { graph[name]; });
+        for (const auto& e : edges) solver.addEdge(names[e.from], names[e.to]);
+
+        auto radius = solver.FindRadius();
+        auto diameter = solver.FindDiameter();
+        auto center = solver.FindCenter();
+        std::sort(center.begin(), center.end());
+        std::vector<size_t> eccentricity;
+        for (const auto& name : names) eccentricity.push_back(solver.FindEccentricity(name));
+        size_t cover = solver.FindMinimumVertexCover().size();
+
+        for (vertexOrder kind : orders) {
+            auto order = ComputeVertexOrder(n, [&g](size_t v) { return g.Neighbours(uint32_t(v)); }, kind);
+            auto sorted = order;
+            std::sort(sorted.begin(), sorted.end());
+            bool permutation = true;
+            for (size_t i = 0; i < n; i++) permutation = permutation && sorted[i] == i;
+
+            compactGraph renumbered = Reorder(g, kind);
+
+            solver.Reorder(kind);
+            auto new_center = solver.FindCenter();
+            std::sort(new_center.begin(), new_center.end());
+            bool same = solver.FindRadius().second == radius.second &&
+                        solver.FindDiameter().second == diameter.second && new_center == center &&
+                        solver.FindMinimumVertexCover().size() == cover;
+            for (size_t v = 0; v < n; v++) same = same && solver.FindEccentricity(names[v]) == eccentricity[v];
+
+            if (!permutation || EdgesByName(renumbered) != EdgesByName(g) || !same) {
+                std::cerr << "graph of " << n << " vertices, order " << int(kind) << ":"
+                          << (permutation ? "" : " not a permutation")
+                          << (EdgesByName(renumbered) == EdgesByName(g) ? "" : " edges changed")
+                          << (same ? "" : " different answers") << '\n';
+                failures++;
+            }
+        }
+    }
+
+    /* A path whose vertices are numbered at random. */
+    std::vector<uint32_t> position(50);
+    for (uint32_t i = 0; i < position.size(); i++) position[i] = i;
+    std::shuffle(position.begin(), position.end(), rng);
+    std::vector<std::string> names;
+    std::vector<compactGraph::edge> edges;
+    for (uint32_t v = 0; v < position.size(); v++) {
+        names.push_back("p" + std::to_string(v));
+        if (v) edges.push_back({position[v - 1], position[v], 1});
+    }
+    compactGraph path = compactGraph::Build(names, edges, false);
+    if (size_t bandwidth = Bandwidth(Reorder(path, vertexOrder::reverseCuthillMcKee)); bandwidth != 1) {
+        std::cerr << "reverse Cuthill-McKee leaves a path with bandwidth " << bandwidth << '\n';
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "lib/routeInspection.h"
+
+namespace {
+    const size_t infinity = SIZE_MAX / 4;
+
+    //A connected graph: a random spanning tree plus `extra` random edges, no parallel edges, weights 1..9.
+    compactGraph RandomGraph(size_t n, size_t extra, std::mt19937& rng) {
+        std::vector<std::string> names;
+        for (size_t v = 0; v < n; v++) names.push_back("v" + std::to_string(v));
+
+        std::map<std::pair<uint32_t, uint32_t>, size_t> weight;
+        for (uint32_t v = 1; v < n; v++) weight[{rng() % v, v}] = 1 + rng() % 9;
+        for (size_t i = 0; i < extra; i++) {
+            uint32_t a = rng() % n, b = rng() % n;
+            if (a != b) weight[{std::min(a, b), std::max(a, b)}] = 1 + rng() % 9;
+        }
+
+        std::vector<compactGraph::edge> edges;
+        for (auto [ends, w] : weight) edges.push_back({ends.first, ends.second, w});
+        return compactGraph::Build(names, edges, true);
+    }
+
+    //A grid of unit edges, whose inner border vertices are odd.
+    compactGraph Grid(size_t side) {
+        std::vector<std::string> names;
+        std::vector<compactGraph::edge> edges;
+        for (size_t v = 0; v < side * side; v++) {
+            names.push_back("v" + std::to_string(v));
+            if (v % side + 1 < side) edges.push_back({uint32_t(v), uint32_t(v + 1), 1});
+            if (v + side < side * side) edges.push_back({uint32_t(v), uint32_t(v + side), 1});
+        }
+        return compactGraph::Build(names, edges, true);
+    }
+
+    //The postman cost by brute force: every edge once plus the cheapest pairing of the odd vertices, trying all
+    //pairings, on Floyd-Warshall distances.
+    size_t BruteForcePostman(const compactGraph& g) {
+        size_t n = g.size();
+        std::vector<std::vector<size_t>> dist(n, std::vector<size_t>(n, infinity));
+        size_t total = 0;
+        std::vector<size_t> odd;
+        for (uint32_t v = 0; v < n; v++) {
+            dist[v][v] = 0;
+            for (size_t arc = g.offsets[v]; arc < g.offsets[v + 1]; arc++) {
+                dist[v][g.targets[arc]] = std::min(dist[v][g.targets[arc]], g.WeightOf(arc));
+                if (v < g.targets[arc]) total += g.WeightOf(arc);
+            }
+            if (g.Neighbours(v).size() % 2) odd.push_back(v);
+        }
+        for (size_t via = 0; via < n; via++) {
+            for (size_t a = 0; a < n; a++) {
+                for (size_t b = 0; b < n; b++) dist[a][b] = std::min(dist[a][b], dist[a][via] + dist[via][b]);
+            }
+        }
+
+        std::vector<bool> paired(odd.size(), false);
+        std::function<size_t()> pairing = [&]() {
+            size_t first = 0;
+            while (first < odd.size() && paired[first]) first++;
+            if (first == odd.size()) return size_t(0);
+
+            size_t best = infinity;
+            paired[first] = true;
+            for (size_t other = first + 1; other < odd.size(); other++) {
+                if (paired[other]) continue;
+                paired[other] = true;
+                best = std::min(best, dist[odd[first]][odd[other]] + pairing());
+                paired[other] = false;
+            }
+            paired[first] = false;
+            return best;
+        };
+
+        return total + pairing();
+    }
+
+    //Whether the walk is closed, steps along edges only, uses every edge at least once and adds up to its length.
+    bool ValidWalk(const compactGraph& g, const postmanWalk& walk) {
+        if (walk.walk.size() < 2 || walk.walk.front() != walk.walk.back()) return false;
+
+        std::map<std::pair<uint32_t, uint32_t>, size_t> uses;
+        size_t length = 0;
+        for (size_t i = 0; i + 1 < walk.walk.size(); i++) {
+            uint32_t from = g.IdOf(walk.walk[i]), to = g.IdOf(walk.walk[i + 1]);
+            size_t arc = g.offsets[from];
+            while (arc < g.offsets[from + 1] && g.targets[arc] != to) arc++;
+            if (arc == g.offsets[from + 1]) return false;
+
+            length += g.WeightOf(arc);
+            uses[{std::min(from, to), std::max(from, to)}]++;
+        }
+
+        size_t edges = 0;
+        for (uint32_t v = 0; v < g.size(); v++) {
+            for (uint32_t to : g.Neighbours(v)) edges += v < to;
+        }
+        return uses.size() == edges && length == walk.length &&
+               walk.walk.size() - 1 == edges + walk.repeated;
+    }
+}
+
+/* PostmanWalk must find the optimal cost on small graphs, where it can be checked by trying every pairing of the
+odd vertices, and every walk it returns, exact, greedy or cut short by the budget, must be a closed walk over every
+edge. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 200; round++) {
+        size_t n = 2 + rng() % 11;
+        compactGraph g = RandomGraph(n, rng() % (2 * n), rng);
+        size_t expected = BruteForcePostman(g);
+
+        postmanWalk exact = PostmanWalk(g, 0);
+        if (!ValidWalk(g, exact) || exact.length != expected || !exact.optimal) {
+            std::cerr << "round " << round << ": exact walk of length " << exact.length << ", expected " << expected
+                      << '\n';
+            failures++;
+        }
+
+        postmanWalk greedy = PostmanWalk(g, 0, 0);
+        if (!ValidWalk(g, greedy) || greedy.length < expected || greedy.optimal != (greedy.odd_vertices == 0)) {
+            std::cerr << "round " << round << ": greedy walk of length " << greedy.length << ", expected at least "
+                      << expected << '\n';
+            failures++;
+        }
+
+        searchBudget budget;
+        budget.node_limit = 1;
+        postmanWalk cut = PostmanWalk(g, 0, postman_exact_limit, budget);
+        if (!ValidWalk(g, cut) || cut.length < expected || cut.optimal != (cut.odd_vertices == 0)) {
+            std::cerr << "round " << round << ": walk cut short by the budget is invalid\n";
+            failures++;
+        }
+    }
+
+    /* Enough odd vertices that many candidate lists are used up and the leftovers search for a partner. */
+    compactGraph grid = Grid(40);
+    postmanWalk walk = PostmanWalk(grid, 0, 0);
+    if (!ValidWalk(grid, walk) || walk.odd_vertices != 4 * 38 || walk.optimal) {
+        std::cerr << "greedy walk of the grid is invalid\n";
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
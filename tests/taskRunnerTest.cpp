@@ -0,0 +1,116 @@
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lib/taskRunner.h"
+
+namespace {
+    //Whether some task depends on itself through a chain of dependencies, by the transitive closure.
+    bool BruteForceCycle(const std::vector<std::vector<size_t>>& dependencies) {
+        size_t n = dependencies.size();
+        std::vector<std::vector<bool>> reaches(n, std::vector<bool>(n, false));
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j : dependencies[i]) reaches[i][j] = true;
+        }
+        for (size_t k = 0; k < n; k++) {
+            for (size_t i = 0; i < n; i++) {
+                for (size_t j = 0; j < n; j++) reaches[i][j] = reaches[i][j] || (reaches[i][k] && reaches[k][j]);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (reaches[i][i]) return true;
+        }
+        return false;
+    }
+
+    std::string Name(size_t task) { return "t" + std::to_string(task); }
+
+    //A task that fails if any of its dependencies has not stored its result yet.
+    analysisTask Task(size_t task, const std::vector<size_t>& dependencies) {
+        analysisTask t{Name(task), {}, nullptr};
+        for (size_t d : dependencies) t.dependencies.push_back(Name(d));
+        t.run = [task, dependencies](const graphSnapshot&, const analysisReport& report) {
+            for (size_t d : dependencies) {
+                if (report.results.at(Name(d)).text != Name(d)) {
+                    throw std::logic_error(Name(task) + " started before " + Name(d));
+                }
+            }
+            return taskResult{task, Name(task)};
+        };
+        return t;
+    }
+}
+
+/* taskRunner::Run must reject exactly the task graphs whose dependencies form a cycle, found here by the transitive
+closure, and must run the others so that every task starts after all its dependencies; unknown dependencies and
+duplicate names must be rejected as well. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    graphSolver g;
+    g.addEdge("a", "b");
+    g.addEdge("b", "c");
+    auto snapshot = std::make_shared<const graphSnapshot>(g);
+
+    for (size_t round = 0; round < 300; round++) {
+        size_t n = 1 + rng() % 10;
+        unsigned density = 5 + rng() % 30;
+
+        /* Most rounds only let a task depend on earlier ones, which can never close a cycle. */
+        bool forward_only = round % 3 != 0;
+        std::vector<std::vector<size_t>> dependencies(n);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if ((forward_only && j >= i) || rng() % 100 >= density) continue;
+                dependencies[i].push_back(j);
+            }
+        }
+
+        taskRunner runner(snapshot, 1 + round % 4);
+        for (size_t i = 0; i < n; i++) runner.Add(Task(i, dependencies[i]));
+
+        bool cycle = BruteForceCycle(dependencies);
+        std::string outcome;
+        try {
+            analysisReport report = runner.Run();
+            for (size_t i = 0; i < n; i++) {
+                if (report.Get<size_t>(Name(i)) != i) outcome = "wrong result";
+            }
+        } catch (const std::invalid_argument& e) {
+            outcome = std::string("rejected: ") + e.what();
+        } catch (const std::exception& e) {
+            outcome = e.what();
+        }
+
+        bool rejected = outcome.find("cycle") != std::string::npos;
+        if (rejected != cycle || (!cycle && !outcome.empty())) {
+            std::cerr << n << " tasks" << (cycle ? " with" : " without") << " a cycle: "
+                      << (outcome.empty() ? "ran" : outcome) << '\n';
+            failures++;
+        }
+    }
+
+    taskRunner unknown(snapshot, 2);
+    unknown.Add(Task(0, {1}));
+    taskRunner duplicate(snapshot, 2);
+    duplicate.Add(Task(0, {}));
+    duplicate.Add(Task(0, {}));
+    for (taskRunner* runner : {&unknown, &duplicate}) {
+        bool rejected = false;
+        try {
+            runner->Run();
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        if (!rejected) {
+            std::cerr << (runner == &unknown ? "an unknown dependency" : "a duplicate task") << " was accepted\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
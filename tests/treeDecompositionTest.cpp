@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/treeDecomposition.h"
+
+namespace {
+    //The size of a maximum stable set by trying every subset, with the rows as bit masks.
+    size_t BruteForceStableSet(const std::vector<uint32_t>& rows) {
+        size_t n = rows.size();
+        size_t best = 0;
+        for (uint32_t subset = 1; subset < (uint32_t(1) << n); subset++) {
+            size_t size = __builtin_popcount(subset);
+            if (size <= best) continue;
+
+            bool stable = true;
+            for (uint32_t rest = subset; rest && stable; rest &= rest - 1) {
+                stable = (subset & rows[__builtin_ctz(rest)]) == 0;
+            }
+            if (stable) best = size;
+        }
+        return best;
+    }
+
+    //Whether every vertex and every edge is in a bag, the bags containing a vertex form one subtree, and the width is
+    //the largest bag size minus one.
+    bool Valid(const std::vector<std::vector<size_t>>& adjacency, const treeDecomposition& d) {
+        size_t n = adjacency.size();
+        if (!d.Complete() || d.bags.size() != n || d.parent.size() != n) return false;
+
+        std::vector<std::vector<bool>> in(n, std::vector<bool>(n, false));
+        size_t width = 0;
+        for (size_t bag = 0; bag < n; bag++) {
+            if (d.bags[bag].empty() || d.bags[bag][0] != bag) return false;
+            for (size_t v : d.bags[bag]) in[bag][v] = true;
+            width = std::max(width, d.bags[bag].size() - 1);
+        }
+
+        for (size_t u = 0; u < n; u++) {
+            for (size_t v : adjacency[u]) {
+                bool together = false;
+                for (size_t bag = 0; bag < n && !together; bag++) together = in[bag][u] && in[bag][v];
+                if (!together) return false;
+            }
+        }
+
+        /* A set of bags is a subtree if exactly one of them has no parent in the set. */
+        for (size_t v = 0; v < n; v++) {
+            size_t tops = 0;
+            for (size_t bag = 0; bag < n; bag++) {
+                if (in[bag][v] && (d.parent[bag] == treeDecomposition::npos || !in[d.parent[bag]][v])) tops++;
+            }
+            if (tops != 1) return false;
+        }
+
+        return width == d.width;
+    }
+
+    //Whether no two of the vertices are adjacent, or, for a cover, every edge has an end among them.
+    bool Check(const std::vector<std::vector<size_t>>& adjacency, const std::vector<size_t>& vertices, bool cover) {
+        std::vector<bool> in(adjacency.size(), false);
+        for (size_t v : vertices) in[v] = true;
+        for (size_t u = 0; u < adjacency.size(); u++) {
+            for (size_t v : adjacency[u]) {
+                if (cover ? !in[u] && !in[v] : in[u] && in[v]) return false;
+            }
+        }
+        return true;
+    }
+}
+
+/* EliminationDecomposition must build a valid tree decomposition with either heuristic, and the dynamic programs over
+it must find a maximum stable set and a minimum vertex cover of the sizes found by trying every subset, on random
+trees, sparse graphs and dense graphs of up to 16 vertices. A width limit must stop the elimination early. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 150; round++) {
+        size_t n = 1 + rng() % 16;
+        size_t kind = round % 3;
+        unsigned density = kind == 1 ? 5 + rng() % 20 : 20 + rng() % 70;
+
+        std::vector<std::vector<size_t>> adjacency(n);
+        std::vector<uint32_t> rows(n, 0);
+        auto link = [&](size_t u, size_t v) {
+            adjacency[u].push_back(v);
+            adjacency[v].push_back(u);
+            rows[u] |= uint32_t(1) << v;
+            rows[v] |= uint32_t(1) << u;
+        };
+        for (size_t v = 1; v < n; v++) {
+            if (kind == 0) {
+                link(rng() % v, v);
+                continue;
+            }
+            for (size_t u = 0; u < v; u++) {
+                if (rng() % 100 < density) link(u, v);
+            }
+        }
+        for (auto& row : adjacency) std::sort(row.begin(), row.end());
+
+        size_t alpha = BruteForceStableSet(rows);
+
+        for (auto heuristic : {eliminationHeuristic::min_degree, eliminationHeuristic::min_fill}) {
+            treeDecomposition d = EliminationDecomposition(adjacency, heuristic);
+            bool valid = Valid(adjacency, d) && (kind != 0 || d.width <= 1);
+
+            auto stable = StableSetByDecomposition(adjacency, d);
+            auto cover = VertexCoverByDecomposition(adjacency, d);
+            if (!valid || stable.size() != alpha || !Check(adjacency, stable, false) || cover.size() != n - alpha ||
+                !Check(adjacency, cover, true)) {
+                std::cerr << "graph of " << n << " vertices, heuristic " << int(heuristic) << ":"
+                          << (valid ? "" : " invalid decomposition") << " stable set " << stable.size() << ", cover "
+                          << cover.size() << ", expected " << alpha << " and " << n - alpha << '\n';
+                failures++;
+            }
+        }
+    }
+
+    /* A clique of 8 vertices needs width 7. */
+    std::vector<std::vector<size_t>> clique(8);
+    for (size_t u = 0; u < 8; u++) {
+        for (size_t v = 0; v < 8; v++) {
+            if (u != v) clique[u].push_back(v);
+        }
+    }
+    treeDecomposition limited = EliminationDecomposition(clique, eliminationHeuristic::min_fill, 3);
+    if (limited.Complete() || limited.width <= 3) {
+        std::cerr << "a width limit of 3 did not stop the elimination of a clique of 8 vertices\n";
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
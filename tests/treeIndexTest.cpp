@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lib/treeIndex.h"
+
+namespace {
+    using weightedNeighbours = std::vector<std::vector<std::pair<uint32_t, size_t>>>;
+
+    //The parent, depth, path weight and heaviest edge from the source to every vertex, by a walk over the tree;
+    //npos and unreachable outside the tree of the source.
+    struct walk {
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> depth;
+        std::vector<size_t> weight;
+        std::vector<size_t> heaviest;
+    };
+
+    walk Walk(const weightedNeighbours& neighbours, uint32_t source) {
+        size_t n = neighbours.size();
+        walk w{std::vector<uint32_t>(n, treeIndex::npos), std::vector<uint32_t>(n, 0),
+               std::vector<size_t>(n, treeIndex::unreachable), std::vector<size_t>(n, treeIndex::unreachable)};
+        w.parent[source] = source;
+        w.weight[source] = 0;
+        w.heaviest[source] = 0;
+        std::vector<uint32_t> stack{source};
+        while (!stack.empty()) {
+            uint32_t v = stack.back();
+            stack.pop_back();
+            for (auto [to, weight] : neighbours[v]) {
+                if (w.parent[to] != treeIndex::npos) continue;
+                w.parent[to] = v;
+                w.depth[to] = w.depth[v] + 1;
+                w.weight[to] = w.weight[v] + weight;
+                w.heaviest[to] = std::max(w.heaviest[v], weight);
+                stack.push_back(to);
+            }
+        }
+        return w;
+    }
+
+    //The lowest common ancestor by climbing from the deeper vertex, with every tree rooted at its smallest id.
+    uint32_t NaiveLca(const std::vector<walk>& from_root, const std::vector<uint32_t>& root, uint32_t a, uint32_t b) {
+        if (root[a] != root[b]) return treeIndex::npos;
+        const walk& w = from_root[root[a]];
+        while (w.depth[a] > w.depth[b]) a = w.parent[a];
+        while (w.depth[b] > w.depth[a]) b = w.parent[b];
+        while (a != b) a = w.parent[a], b = w.parent[b];
+        return a;
+    }
+
+    std::string Name(size_t v) {
+        std::string digits = std::to_string(v);
+        return "v" + std::string(3 - digits.size(), '0') + digits;
+    }
+}
+
+/* The lowest common ancestor, the path weight, the heaviest edge and the nearest marked vertex of a treeIndex must
+match a walk over the tree from the query vertex, on random forests of up to 80 vertices, while vertices are marked
+one by one and after the marks are cleared. A set of edges with a cycle must be rejected. */
+int main() {
+    int failures = 0;
+    std::mt19937 rng(1);
+
+    for (size_t round = 0; round < 60; round++) {
+        size_t n = 2 + rng() % 79;
+
+        /* Every vertex hangs below an earlier one with probability 4/5, so there are a few trees; the edges are
+        listed in random order and direction. Names are zero-padded, so the ids of the index are the vertex numbers. */
+        spanningTree tree;
+        std::vector<bool> in_tree(n, false);
+        for (uint32_t v = 1; v < n; v++) {
+            if (rng() % 5 == 0) continue;
+            uint32_t u = rng() % v;
+            size_t weight = rng() % 30;
+            if (rng() % 2) tree.push_back({{Name(u), Name(v)}, weight});
+            else tree.push_back({{Name(v), Name(u)}, weight});
+            in_tree[u] = in_tree[v] = true;
+        }
+        std::shuffle(tree.begin(), tree.end(), rng);
+
+        /* Vertices without edges are not in the index, so the naive side renumbers the others in order. */
+        std::vector<uint32_t> id(n, treeIndex::npos);
+        uint32_t count = 0;
+        for (size_t v = 0; v < n; v++) {
+            if (in_tree[v]) id[v] = count++;
+        }
+        weightedNeighbours neighbours(count);
+        for (const auto& [edge, weight] : tree) {
+            uint32_t a = id[std::stoul(edge.first.substr(1))], b = id[std::stoul(edge.second.substr(1))];
+            neighbours[a].push_back({b, weight});
+            neighbours[b].push_back({a, weight});
+        }
+
+        treeIndex index(tree);
+        bool ids = index.size() == count;
+        for (size_t v = 0; v < n && ids; v++) ids = !in_tree[v] || index.index_of.at(Name(v)) == id[v];
+
+        std::vector<walk> from(count);
+        std::vector<uint32_t> root(count, treeIndex::npos);
+        for (uint32_t v = 0; v < count; v++) {
+            from[v] = Walk(neighbours, v);
+            if (root[v] != treeIndex::npos) continue;
+            for (uint32_t u = 0; u < count; u++) {
+                if (from[v].parent[u] != treeIndex::npos) root[u] = v;
+            }
+        }
+
+        bool paths = ids;
+        for (uint32_t a = 0; a < count && paths; a++) {
+            for (uint32_t b = 0; b < count && paths; b++) {
+                paths = index.Lca(a, b) == NaiveLca(from, root, a, b) && index.PathWeight(a, b) == from[a].weight[b] &&
+                        index.HeaviestEdge(a, b) == from[a].heaviest[b];
+            }
+        }
+
+        /* Marking a random order of vertices, with every vertex queried after each mark, then clearing them. */
+        bool nearest = paths;
+        std::vector<uint32_t> order(count);
+        for (uint32_t v = 0; v < count; v++) order[v] = v;
+        std::shuffle(order.begin(), order.end(), rng);
+        std::vector<bool> marked(count, false);
+        size_t marks = std::min<size_t>(count, 1 + rng() % 6);
+        for (size_t step = 0; step <= marks + 1 && nearest; step++) {
+            if (step == marks + 1) {
+                index.ClearMarks();
+                std::fill(marked.begin(), marked.end(), false);
+            } else if (step > 0) {
+                index.Mark(order[step - 1]);
+                marked[order[step - 1]] = true;
+            }
+
+            for (uint32_t v = 0; v < count && nearest; v++) {
+                size_t best = treeIndex::unreachable;
+                for (uint32_t u = 0; u < count; u++) {
+                    if (marked[u]) best = std::min(best, from[v].weight[u]);
+                }
+                auto [vertex, weight] = index.NearestMarked(v);
+                nearest = weight == best && (best == treeIndex::unreachable
+                                                 ? vertex == treeIndex::npos
+                                                 : marked[vertex] && from[v].weight[vertex] == best);
+            }
+        }
+
+        if (!paths || !nearest) {
+            std::cerr << "forest of " << count << " vertices:" << (ids ? "" : " wrong ids")
+                      << (paths ? "" : " wrong path queries") << (nearest ? "" : " wrong nearest marked vertex")
+                      << '\n';
+            failures++;
+        }
+    }
+
+    bool rejected = false;
+    try {
+        treeIndex cycle({{{"a", "b"}, 1}, {{"b", "c"}, 1}, {{"c", "a"}, 1}});
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    if (!rejected) {
+        std::cerr << "a triangle was accepted as a tree\n";
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}